@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "data/CsvPriceSource.h"
+
+// Compares CSV ingestion throughput (rows/sec) of the previous
+// getline + stringstream + stod parser against CsvPriceSource::fetch,
+// single-threaded and with chunked parallel parsing.
+//
+// Usage: csv_bench [num_rows]
+
+namespace {
+
+// The CsvPriceSource::fetch implementation this benchmark replaces.
+std::vector<Bar> legacyFetch(const std::string& path) {
+    std::ifstream file(path);
+    std::vector<Bar> bars;
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        Bar bar;
+        std::getline(ss, cell, ',');
+        bar.timestamp = std::stoll(cell);
+        std::getline(ss, cell, ',');
+        bar.open = std::stod(cell);
+        std::getline(ss, cell, ',');
+        bar.high = std::stod(cell);
+        std::getline(ss, cell, ',');
+        bar.low = std::stod(cell);
+        std::getline(ss, cell, ',');
+        bar.close = std::stod(cell);
+        std::getline(ss, cell, ',');
+        bar.volume = std::stod(cell);
+        if (std::getline(ss, cell, ',')) {
+            bar.num_trades = std::stoll(cell);
+        }
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+std::vector<Bar> makeBars(std::size_t n) {
+    std::vector<Bar> bars(n);
+    double price = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        Bar& bar = bars[i];
+        bar.timestamp = 1672531200000 + static_cast<std::int64_t>(i) * 60000;
+        bar.open = price;
+        price += (i % 7 < 3 ? 1.25 : -0.75);
+        bar.close = price;
+        bar.high = std::max(bar.open, bar.close) + 2.5;
+        bar.low = std::min(bar.open, bar.close) - 2.5;
+        bar.volume = 100.0 + static_cast<double>(i % 1000) * 0.37;
+        bar.num_trades = static_cast<std::int64_t>(i % 5000);
+    }
+    return bars;
+}
+
+template <typename F>
+void measure(const std::string& label, std::size_t rows, F&& fetch) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto bars = fetch();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (bars.size() != rows) {
+        std::cerr << label << ": expected " << rows << " rows, got " << bars.size() << "\n";
+        std::exit(1);
+    }
+    std::cout << std::left << std::setw(10) << label
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+              << static_cast<double>(rows) / seconds << " rows/sec"
+              << std::setw(12) << std::setprecision(3) << seconds << " s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t numRows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3'000'000;
+    const std::string path = (std::filesystem::temp_directory_path() / "csv_bench.csv").string();
+
+    CsvPriceSource::write(path, makeBars(numRows));
+    std::cout << "--- CSV ingestion benchmark (" << numRows << " rows, "
+              << std::filesystem::file_size(path) / (1024 * 1024) << " MiB) ---\n";
+
+    measure("before", numRows, [&] { return legacyFetch(path); });
+    measure("after", numRows, [&] { return CsvPriceSource{path, 1}.fetch(); });
+    measure("parallel", numRows, [&] { return CsvPriceSource{path}.fetch(); });
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/BacktestManager.h"
+#include "engine/ExecutionEngine.h"
+#include "engine/ThreadPool.h"
+
+// Measures strategy dispatch throughput (bars/sec) of the execution engine:
+//   inline      - one engine, strategy called directly on the bar loop thread
+//   pool/bar    - the previous behaviour: one ThreadPool round-trip per bar
+//   pooled xN   - N engines over the same bars, run concurrently on a ThreadPool
+//
+// Usage: engine_bench [num_bars] [num_strategies]
+
+namespace {
+
+std::vector<Bar> makeBars(std::size_t n) {
+    std::vector<Bar> bars;
+    bars.reserve(n);
+    double price = 100.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double drift = std::sin(static_cast<double>(i) * 0.001) * 0.05;
+        Bar bar;
+        bar.timestamp = 1672531200000 + static_cast<std::int64_t>(i) * 60000;
+        bar.open = price;
+        price += drift;
+        bar.close = price;
+        bar.high = std::max(bar.open, bar.close) + 0.01;
+        bar.low = std::min(bar.open, bar.close) - 0.01;
+        bar.volume = 1.0;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+// Never trades, so the measurement is dominated by dispatch overhead.
+class NullStrategy : public IStrategy {
+public:
+    void on_start(const Bar&, double) override {}
+
+    StrategyAction on_bar(const Bar& currentBar, const std::vector<Position>&, double) override {
+        checksum_ += currentBar.close;
+        return {};
+    }
+
+    void on_finish() override {}
+
+    const StrategyConfig& getConfig() const override { return config_; }
+
+    double checksum() const { return checksum_; }
+
+private:
+    StrategyConfig config_;
+    double checksum_{0.0};
+};
+
+template <typename F>
+double secondsFor(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& label, std::size_t bars, double seconds) {
+    std::cout << std::left << std::setw(16) << label
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+              << static_cast<double>(bars) / seconds << " bars/sec"
+              << std::setw(12) << std::setprecision(3) << seconds << " s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t numBars = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const std::size_t numStrategies = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                               : std::max(2u, std::thread::hardware_concurrency());
+
+    const auto bars = makeBars(numBars);
+    std::cout << "--- Engine dispatch benchmark (" << numBars << " bars) ---\n";
+
+    {
+        auto strategy = std::make_shared<NullStrategy>();
+        ExecutionEngine engine{strategy};
+        report("inline", numBars, secondsFor([&] { engine.run(bars); }));
+    }
+
+    {
+        auto strategy = std::make_shared<NullStrategy>();
+        ThreadPool pool{1};
+        std::vector<Position> positions;
+        const double seconds = secondsFor([&] {
+            for (const auto& bar : bars) {
+                auto fut = pool.enqueue([&] { return strategy->on_bar(bar, positions, 0.0); });
+                fut.get();
+            }
+        });
+        report("pool/bar", numBars, seconds);
+    }
+
+    {
+        std::vector<std::shared_ptr<IStrategy>> strategies;
+        for (std::size_t i = 0; i < numStrategies; ++i) {
+            strategies.push_back(std::make_shared<NullStrategy>());
+        }
+        const double seconds = secondsFor([&] { BacktestManager::runAll(bars, strategies); });
+        report("pooled x" + std::to_string(numStrategies), numBars * numStrategies, seconds);
+    }
+
+    return 0;
+}
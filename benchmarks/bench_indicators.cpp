@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "indicators/BatchKernels.h"
+
+// Compares the batch indicator kernels against the naive scalar loops they
+// replace, over one synthetic close column (values/sec):
+//   naive  - per-output window recompute (SMA, stddev) / single scalar loop
+//   batch  - indicators::batch kernels
+//
+// Usage: indicator_bench [num_values] [period]
+
+namespace {
+
+std::vector<double> makeColumn(std::size_t n) {
+    std::vector<double> values(n);
+    double price = 20000.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        price += std::sin(static_cast<double>(i) * 0.001) * 5.0;
+        values[i] = price;
+    }
+    return values;
+}
+
+void naiveSma(const std::vector<double>& in, std::size_t period, std::vector<double>& out) {
+    for (std::size_t i = period - 1; i < in.size(); ++i) {
+        const auto first = in.begin() + static_cast<std::ptrdiff_t>(i + 1 - period);
+        out[i] = std::accumulate(first, first + static_cast<std::ptrdiff_t>(period), 0.0) /
+                 static_cast<double>(period);
+    }
+}
+
+void naiveRollingSma(const std::vector<double>& in, std::size_t period, std::vector<double>& out) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        sum += in[i];
+        if (i >= period) sum -= in[i - period];
+        if (i + 1 >= period) out[i] = sum / static_cast<double>(period);
+    }
+}
+
+void naiveStdDev(const std::vector<double>& in, std::size_t period, std::vector<double>& out) {
+    for (std::size_t i = period - 1; i < in.size(); ++i) {
+        double mean = 0.0;
+        for (std::size_t k = i + 1 - period; k <= i; ++k) mean += in[k];
+        mean /= static_cast<double>(period);
+        double sq = 0.0;
+        for (std::size_t k = i + 1 - period; k <= i; ++k) sq += (in[k] - mean) * (in[k] - mean);
+        out[i] = std::sqrt(sq / static_cast<double>(period));
+    }
+}
+
+void naiveReturns(const std::vector<double>& in, std::vector<double>& out) {
+    for (std::size_t i = 1; i < in.size(); ++i) {
+        out[i] = (in[i] - in[i - 1]) / in[i - 1];
+    }
+}
+
+template <typename F>
+double secondsFor(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Keeps the optimiser from discarding an output nobody reads.
+double sink = 0.0;
+
+void report(const std::string& label, std::size_t values, double seconds, const std::vector<double>& out) {
+    sink += out[out.size() / 2];
+    std::cout << std::left << std::setw(22) << label
+              << std::right << std::setw(16) << std::fixed << std::setprecision(0)
+              << static_cast<double>(values) / seconds << " values/sec"
+              << std::setw(12) << std::setprecision(3) << seconds << " s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+    const std::size_t period = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    if (period == 0 || n < period) {
+        std::cerr << "num_values must be >= period > 0\n";
+        return 1;
+    }
+
+    const auto in = makeColumn(n);
+    std::vector<double> out(n, 0.0);
+    std::cout << "--- Indicator kernel benchmark (" << n << " values, period " << period << ") ---\n";
+
+    report("sma naive", n, secondsFor([&] { naiveSma(in, period, out); }), out);
+    report("sma naive rolling", n, secondsFor([&] { naiveRollingSma(in, period, out); }), out);
+    report("sma batch", n, secondsFor([&] { indicators::batch::sma(in.data(), n, period, out.data()); }), out);
+    report("ema batch", n, secondsFor([&] { indicators::batch::ema(in.data(), n, period, out.data()); }), out);
+    report("stddev naive", n, secondsFor([&] { naiveStdDev(in, period, out); }), out);
+    report("stddev batch", n,
+           secondsFor([&] { indicators::batch::rollingStdDev(in.data(), n, period, out.data()); }), out);
+    report("returns naive", n, secondsFor([&] { naiveReturns(in, out); }), out);
+    report("returns batch", n, secondsFor([&] { indicators::batch::returns(in.data(), n, out.data()); }), out);
+    report("log returns batch", n,
+           secondsFor([&] { indicators::batch::logReturns(in.data(), n, out.data()); }), out);
+
+    std::cout << "(checksum " << sink << ")\n";
+    return 0;
+}
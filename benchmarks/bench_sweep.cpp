@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/Log.h"
+#include "core/Topology.h"
+#include "engine/BacktestManager.h"
+#include "engine/ParameterGrid.h"
+#include "sma_cross/SmaCrossStrategy.h"
+
+// Measures parameter-sweep throughput as the worker count grows, for each
+// thread placement. A row's worker count is exactly the number of engines
+// running at once (the calling thread only waits), so the 1-worker row is a
+// true single-threaded baseline.
+//   shared     - unpinned workers, one copy of the bars
+//   pinned     - workers pinned across NUMA nodes, one copy of the bars
+//   replicated - pinned workers, one copy of the bars per NUMA node
+// On a single-node machine the replicated column matches pinned.
+//
+// Usage: sweep_bench [num_bars] [num_combinations] [max_threads]
+
+namespace {
+
+std::vector<Bar> makeBars(std::size_t n) {
+    std::vector<Bar> bars;
+    bars.reserve(n);
+    double price = 100.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double drift = std::sin(static_cast<double>(i) * 0.001) * 0.05;
+        Bar bar;
+        bar.timestamp = 1672531200000 + static_cast<std::int64_t>(i) * 60000;
+        bar.open = price;
+        price += drift;
+        bar.close = price;
+        bar.high = std::max(bar.open, bar.close) + 0.01;
+        bar.low = std::min(bar.open, bar.close) - 0.01;
+        bar.volume = 1.0;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+double secondsFor(const std::shared_ptr<const std::vector<Bar>>& bars, const ParameterGrid& grid,
+                  const RunnerOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    BacktestManager::sweep(bars, grid, StrategyConfig{}, [](const StrategyConfig& c) {
+        return std::make_shared<SmaCrossStrategy>(c);
+    }, options);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t numBars = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500'000;
+    const std::size_t numCombinations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    const std::size_t maxThreads =
+        argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    logging::setLevel(logging::Level::Warn);
+
+    const auto& topo = topology::Topology::system();
+    std::cout << "--- Sweep scaling benchmark (" << numBars << " bars x " << numCombinations
+              << " runs) ---\n"
+              << topo.cpuCount() << " CPUs on " << topo.nodeCount() << " NUMA node(s)\n";
+
+    const auto bars = std::make_shared<const std::vector<Bar>>(makeBars(numBars));
+    ParameterGrid grid;
+    std::vector<double> periods;
+    for (std::size_t i = 0; i < numCombinations; ++i) {
+        periods.push_back(static_cast<double>(10 + i));
+    }
+    grid.addAxis("smaPeriod", periods);
+
+    std::cout << std::left << std::setw(9) << "Workers";
+    for (const char* label : {"shared", "pinned", "replicated"}) {
+        std::cout << std::right << std::setw(19) << label << std::setw(9) << "speedup";
+    }
+    std::cout << "\n";
+
+    double baseline[3] = {0.0, 0.0, 0.0};
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        std::cout << std::left << std::setw(9) << threads << std::right << std::fixed;
+        for (int mode = 0; mode < 3; ++mode) {
+            const RunnerOptions options{threads, mode > 0, mode == 2};
+            const double seconds = secondsFor(bars, grid, options);
+            if (threads == 1) baseline[mode] = seconds;
+            std::cout << std::setprecision(0) << std::setw(11)
+                      << static_cast<double>(numBars * numCombinations) / seconds / 1e3 << " kbars/s"
+                      << std::setprecision(2) << std::setw(8) << baseline[mode] / seconds << "x";
+        }
+        std::cout << "\n";
+        if (threads >= maxThreads) break;
+    }
+    return 0;
+}
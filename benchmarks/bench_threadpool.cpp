@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/ThreadPool.h"
+
+// Measures task throughput of the thread pool on tiny tasks, where queueing
+// overhead dominates:
+//   mutex pool + future - the previous design: one locked std::queue of
+//                         std::function, a shared_ptr<packaged_task> per task
+//   enqueue + future    - ThreadPool::enqueue, one future per task
+//   submit              - ThreadPool::submit, no future
+//   parallel_for        - ThreadPool::parallel_for over the same index range
+//   nested submit       - tasks submitted from inside workers (local deques)
+//
+// Usage: threadpool_bench [num_tasks] [num_threads]
+
+namespace {
+
+// The pre-work-stealing pool, kept here as the baseline.
+class MutexPool {
+public:
+    explicit MutexPool(std::size_t threads) {
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock lock{mutex_};
+                        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                        if (stop_ && tasks_.empty()) return;
+                        task = std::move(tasks_.front());
+                        tasks_.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~MutexPool() {
+        {
+            std::lock_guard lock{mutex_};
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    template <typename F>
+    auto enqueue(F&& f) -> std::future<std::invoke_result_t<F>> {
+        using ReturnT = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<ReturnT()>>(std::forward<F>(f));
+        std::future<ReturnT> result = task->get_future();
+        {
+            std::lock_guard lock{mutex_};
+            tasks_.emplace([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_{false};
+};
+
+// A few nanoseconds of work the compiler cannot drop.
+inline void spin(std::atomic<std::uint64_t>& sink, std::size_t i) {
+    sink.fetch_add(i * 2654435761u, std::memory_order_relaxed);
+}
+
+template <typename Fn>
+void report(const std::string& label, std::size_t tasks, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << elapsed.count() * 1e3 << " ms" << std::setw(14)
+              << static_cast<double>(tasks) / elapsed.count() / 1e6 << " Mtasks/s\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t numTasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t numThreads =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "Thread pool benchmark: " << numTasks << " tasks, " << numThreads << " threads\n";
+    std::atomic<std::uint64_t> sink{0};
+
+    report("mutex pool + future", numTasks, [&] {
+        MutexPool pool{numThreads};
+        std::vector<std::future<void>> futures;
+        futures.reserve(numTasks);
+        for (std::size_t i = 0; i < numTasks; ++i) {
+            futures.push_back(pool.enqueue([&sink, i] { spin(sink, i); }));
+        }
+        for (auto& future : futures) future.get();
+    });
+
+    report("enqueue + future", numTasks, [&] {
+        ThreadPool pool{numThreads};
+        std::vector<std::future<void>> futures;
+        futures.reserve(numTasks);
+        for (std::size_t i = 0; i < numTasks; ++i) {
+            futures.push_back(pool.enqueue([&sink, i] { spin(sink, i); }));
+        }
+        for (auto& future : futures) future.get();
+    });
+
+    report("submit", numTasks, [&] {
+        ThreadPool pool{numThreads};
+        for (std::size_t i = 0; i < numTasks; ++i) {
+            pool.submit([&sink, i] { spin(sink, i); });
+        }
+    });
+
+    report("parallel_for", numTasks, [&] {
+        ThreadPool pool{numThreads};
+        pool.parallel_for(0, numTasks, [&sink](std::size_t i) { spin(sink, i); });
+    });
+
+    report("nested submit", numTasks, [&] {
+        ThreadPool pool{numThreads};
+        const std::size_t producers = numThreads * 4;
+        const std::size_t perProducer = numTasks / producers;
+        for (std::size_t p = 0; p < producers; ++p) {
+            pool.submit([&pool, &sink, perProducer] {
+                for (std::size_t i = 0; i < perProducer; ++i) {
+                    pool.submit([&sink, i] { spin(sink, i); });
+                }
+            });
+        }
+    });
+
+    std::cout << "(checksum " << sink.load() << ")\n";
+    return 0;
+}
@@ -1,23 +1,92 @@
 #pragma once
 
+#include "core/Metrics.h"
 #include "core/Trade.h"
 #include <vector>
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 
+// Aggregate statistics over an account's closed trades.
+struct AccountSummary {
+    double initialBalance{0.0};
+    double finalBalance{0.0};
+    double netPnl{0.0};
+    double grossPnl{0.0};
+    double totalFees{0.0};
+    double totalFunding{0.0}; // net funding paid (negative if received)
+    int totalTrades{0};
+    double winRate{0.0};     // fraction of trades with positive PnL
+    double sharpeRatio{0.0}; // per-trade mean PnL over its standard deviation
+    int longTrades{0};
+    double netPnlLong{0.0};
+    int shortTrades{0};
+    double netPnlShort{0.0};
+    metrics::RiskMetrics risk; // from the mark-to-market equity curve
+};
+
+// One mark of the equity curve, kept only when recording is enabled.
+struct EquityPoint {
+    std::int64_t timestamp{0};
+    double equity{0.0};
+    double drawdown{0.0}; // fraction below the running peak
+};
+
 class Account {
 public:
     explicit Account(double initialBalance);
 
     void recordTrade(const Trade& trade);
 
+    // Preallocates room for count closed trades, so recording them during a
+    // run does not reallocate.
+    void reserveTrades(std::size_t count) { closedTrades_.reserve(count); }
+
+    [[nodiscard]] AccountSummary summarize() const;
+
+    [[nodiscard]] const std::vector<Trade>& trades() const { return closedTrades_; }
+
     void printSummary() const;
 
     [[nodiscard]] double getBalance() const { return balance_; }
 
     void setBalance(double balance) { balance_ = balance; }
 
+    // Margin bookkeeping for open positions. Available margin is the realized
+    // balance minus the collateral currently held by open positions.
+    void reserveMargin(double amount) { usedMargin_ += amount; }
+    void releaseMargin(double amount) { usedMargin_ = std::max(0.0, usedMargin_ - amount); }
+    [[nodiscard]] double usedMargin() const { return usedMargin_; }
+    [[nodiscard]] double availableMargin() const { return balance_ - usedMargin_; }
+
+    // Marks the account to market at the close of a bar: equity is the
+    // realized balance plus openPnl, the unrealized PnL of all open positions
+    // net of their accrued costs. Call once per timestamp, after the bar's
+    // fills.
+    void markToMarket(std::int64_t timestamp, double openPnl, bool exposed) {
+        equity_.mark(timestamp, balance_ + openPnl, exposed);
+        if (recordEquity_) {
+            equityPoints_.push_back({timestamp, equity_.equity(), equity_.drawdown()});
+        }
+    }
+
+    // Keeps every mark in equityPoints() (off by default: the risk metrics
+    // need no stored curve). reserveBars presizes it so marking stays
+    // allocation-free.
+    void recordEquityCurve(std::size_t reserveBars = 0) {
+        recordEquity_ = true;
+        equityPoints_.reserve(reserveBars);
+    }
+    [[nodiscard]] const std::vector<EquityPoint>& equityPoints() const { return equityPoints_; }
+
+    [[nodiscard]] const metrics::EquityTracker& equityCurve() const { return equity_; }
+
 private:
     double initialBalance_;
     double balance_;
     std::vector<Trade> closedTrades_;
+    double usedMargin_{0.0};
+    metrics::EquityTracker equity_;
+    bool recordEquity_{false};
+    std::vector<EquityPoint> equityPoints_;
 }; 
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <span>
+#include <vector>
+#include "core/Bar.h"
+
+// Allocator handing out storage aligned to Alignment bytes (a cache line by
+// default), so every BarSeries column starts on a cache-line/SIMD boundary.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Structure-of-arrays bar container: one aligned column per Bar field.
+//
+// Scans that only need one or two fields (closes, highs/lows, timestamps) read
+// contiguous memory instead of striding over 56-byte rows. row(i) assembles a
+// Bar for code written against the row type, such as IStrategy::on_bar.
+class BarSeries {
+public:
+    BarSeries() = default;
+    explicit BarSeries(std::size_t count) { resize(count); }
+
+    static BarSeries fromBars(std::span<const Bar> bars) {
+        BarSeries series(bars.size());
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            series.set(i, bars[i]);
+        }
+        return series;
+    }
+
+    [[nodiscard]] std::vector<Bar> toBars() const {
+        std::vector<Bar> bars(size());
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            bars[i] = row(i);
+        }
+        return bars;
+    }
+
+    [[nodiscard]] std::size_t size() const { return timestamp_.size(); }
+    [[nodiscard]] bool empty() const { return timestamp_.empty(); }
+
+    void reserve(std::size_t count) {
+        timestamp_.reserve(count);
+        open_.reserve(count);
+        high_.reserve(count);
+        low_.reserve(count);
+        close_.reserve(count);
+        volume_.reserve(count);
+        numTrades_.reserve(count);
+    }
+
+    void resize(std::size_t count) {
+        timestamp_.resize(count);
+        open_.resize(count);
+        high_.resize(count);
+        low_.resize(count);
+        close_.resize(count);
+        volume_.resize(count);
+        numTrades_.resize(count);
+    }
+
+    void clear() { resize(0); }
+
+    void push_back(const Bar& bar) {
+        timestamp_.push_back(bar.timestamp);
+        open_.push_back(bar.open);
+        high_.push_back(bar.high);
+        low_.push_back(bar.low);
+        close_.push_back(bar.close);
+        volume_.push_back(bar.volume);
+        numTrades_.push_back(bar.num_trades);
+    }
+
+    // Assembles row i. Cheap (seven loads), but prefer the columns for scans.
+    [[nodiscard]] Bar row(std::size_t i) const {
+        return Bar{timestamp_[i], open_[i], high_[i], low_[i], close_[i], volume_[i], numTrades_[i]};
+    }
+    [[nodiscard]] Bar operator[](std::size_t i) const { return row(i); }
+
+    void set(std::size_t i, const Bar& bar) {
+        timestamp_[i] = bar.timestamp;
+        open_[i] = bar.open;
+        high_[i] = bar.high;
+        low_[i] = bar.low;
+        close_[i] = bar.close;
+        volume_[i] = bar.volume;
+        numTrades_[i] = bar.num_trades;
+    }
+
+    [[nodiscard]] std::span<const std::int64_t> timestamps() const { return timestamp_; }
+    [[nodiscard]] std::span<const double> opens() const { return open_; }
+    [[nodiscard]] std::span<const double> highs() const { return high_; }
+    [[nodiscard]] std::span<const double> lows() const { return low_; }
+    [[nodiscard]] std::span<const double> closes() const { return close_; }
+    [[nodiscard]] std::span<const double> volumes() const { return volume_; }
+    [[nodiscard]] std::span<const std::int64_t> numTrades() const { return numTrades_; }
+
+    [[nodiscard]] std::span<std::int64_t> timestamps() { return timestamp_; }
+    [[nodiscard]] std::span<double> opens() { return open_; }
+    [[nodiscard]] std::span<double> highs() { return high_; }
+    [[nodiscard]] std::span<double> lows() { return low_; }
+    [[nodiscard]] std::span<double> closes() { return close_; }
+    [[nodiscard]] std::span<double> volumes() { return volume_; }
+    [[nodiscard]] std::span<std::int64_t> numTrades() { return numTrades_; }
+
+private:
+    AlignedVector<std::int64_t> timestamp_;
+    AlignedVector<double> open_;
+    AlignedVector<double> high_;
+    AlignedVector<double> low_;
+    AlignedVector<double> close_;
+    AlignedVector<double> volume_;
+    AlignedVector<std::int64_t> numTrades_;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+// Compile-time floor for log statements: anything below it compiles to
+// nothing. 0 = trace ... 4 = error, 5 = off. Set through the
+// BACKTEST_LOG_MIN_LEVEL CMake cache variable.
+#ifndef BACKTEST_LOG_MIN_LEVEL
+#define BACKTEST_LOG_MIN_LEVEL 0
+#endif
+
+// Leveled, buffered logging for the engine, strategies and data layer.
+//
+// A statement formats into a buffer owned by the calling thread, so threads
+// never contend on a stream lock while formatting. Each thread's buffer is
+// handed to a background flusher once it grows past a few KiB, on warnings
+// and errors, on flush(), when the thread exits, and otherwise at least every
+// 100 ms, so a slow trickle of progress lines still shows up promptly. The
+// flusher writes whole buffers to stdout (trace..info) or stderr (warn,
+// error). Nothing is flushed per line.
+//
+//   LOG_DEBUG << "EXEC: Opened position #" << id;
+//
+// Statements below the runtime level cost one relaxed atomic load and do not
+// evaluate their arguments; statements below BACKTEST_LOG_MIN_LEVEL are
+// removed at compile time.
+namespace logging {
+
+enum class Level : int { Trace = 0, Debug, Info, Warn, Error, Off };
+
+inline constexpr Level kMinLevel = static_cast<Level>(BACKTEST_LOG_MIN_LEVEL);
+
+// Runtime threshold; Info by default.
+void setLevel(Level level);
+Level level();
+
+// "trace", "debug", "info", "warn", "error" or "off"; throws std::invalid_argument otherwise.
+Level parseLevel(const std::string& name);
+
+// True if a statement at level l would be emitted.
+inline bool enabled(Level l) {
+    return l >= kMinLevel && l != Level::Off && l >= level();
+}
+
+// Hands every thread's buffered lines to the flusher and waits until they
+// have been written. Call before writing to std::cout directly (e.g. a
+// summary table) so log lines completed before the call, on any thread,
+// come first.
+void flush();
+
+// One log statement: collects the streamed values in the thread's line
+// buffer and appends the finished line to the thread's output buffer.
+class Line {
+public:
+    explicit Line(Level level);
+    ~Line();
+    Line(const Line&) = delete;
+    Line& operator=(const Line&) = delete;
+
+    template <typename T>
+    Line& operator<<(const T& value) {
+        stream_ << value;
+        return *this;
+    }
+
+private:
+    Level level_;
+    std::ostringstream& stream_;
+};
+
+} // namespace logging
+
+#define BACKTEST_LOG(level) \
+    if (!::logging::enabled(level)) {} else ::logging::Line(level)
+
+#define LOG_TRACE BACKTEST_LOG(::logging::Level::Trace)
+#define LOG_DEBUG BACKTEST_LOG(::logging::Level::Debug)
+#define LOG_INFO BACKTEST_LOG(::logging::Level::Info)
+#define LOG_WARN BACKTEST_LOG(::logging::Level::Warn)
+#define LOG_ERROR BACKTEST_LOG(::logging::Level::Error)
@@ -1,10 +1,138 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
 namespace metrics {
 
-// Placeholder Sharpe ratio calculation
-inline double sharpe(double /*averageReturn*/, double /*stdDev*/, double /*riskFreeRate = 0.0*/) {
-    return 0.0;  // TODO: implement
+inline constexpr double kMillisPerYear = 365.0 * 24 * 3'600'000.0;
+
+// Ratio of mean excess return to its standard deviation, per sample period.
+inline double sharpe(double averageReturn, double stdDev, double riskFreeRate = 0.0) {
+    return stdDev > 0 ? (averageReturn - riskFreeRate) / stdDev : 0.0;
 }
 
-} // namespace metrics 
\ No newline at end of file
+// Welford's online mean and variance: one pass, O(1) state, and numerically
+// stable for long series of small returns.
+class RunningStats {
+public:
+    void add(double x) {
+        ++count_;
+        const double delta = x - mean_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (x - mean_);
+    }
+
+    [[nodiscard]] std::size_t count() const { return count_; }
+    [[nodiscard]] double mean() const { return mean_; }
+    // Sample variance; zero with fewer than two samples.
+    [[nodiscard]] double variance() const { return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0; }
+    [[nodiscard]] double stdDev() const { return std::sqrt(variance()); }
+
+private:
+    std::size_t count_{0};
+    double mean_{0.0};
+    double m2_{0.0};
+};
+
+// Risk and performance figures of one equity curve. Ratios are annualized
+// from the average spacing of the marked bars.
+struct RiskMetrics {
+    double finalEquity{0.0};
+    double totalReturn{0.0};     // final / initial equity - 1
+    double annualReturn{0.0};    // compounded over the marked time span
+    double volatility{0.0};      // annualized standard deviation of bar returns
+    double maxDrawdown{0.0};     // largest peak-to-trough decline, as a fraction of the peak
+    double sharpe{0.0};
+    double sortino{0.0};         // mean return over downside deviation (target 0)
+    double calmar{0.0};          // annual return over max drawdown
+    double exposure{0.0};        // fraction of bars with an open position
+    double turnover{0.0};        // traded notional over average equity
+    std::size_t bars{0};
+};
+
+// Streams a mark-to-market equity curve one bar at a time and keeps only
+// running aggregates, so memory is O(1) regardless of run length. Bar returns
+// feed a Welford accumulator (Sharpe, volatility) plus a downside sum of
+// squares (Sortino); the running peak yields drawdown.
+class EquityTracker {
+public:
+    explicit EquityTracker(double initialEquity)
+        : initialEquity_{initialEquity}, equity_{initialEquity}, peak_{initialEquity} {}
+
+    // Records the equity at the close of the bar at timestamp (ms) and whether
+    // any position was open over it.
+    void mark(std::int64_t timestamp, double equity, bool exposed) {
+        if (bars_ == 0) {
+            firstTimestamp_ = timestamp;
+        }
+        const double r = equity_ != 0.0 ? equity / equity_ - 1.0 : 0.0;
+        returns_.add(r);
+        if (r < 0) {
+            downsideSq_ += r * r;
+        }
+        equityStats_.add(equity);
+
+        equity_ = equity;
+        peak_ = std::max(peak_, equity);
+        if (peak_ > 0) {
+            maxDrawdown_ = std::max(maxDrawdown_, 1.0 - equity / peak_);
+        }
+        exposedBars_ += exposed ? 1 : 0;
+        lastTimestamp_ = timestamp;
+        ++bars_;
+    }
+
+    // Adds filled notional (both legs of every trade) to the turnover count.
+    void addTraded(double notional) { traded_ += notional; }
+
+    [[nodiscard]] double equity() const { return equity_; }
+    [[nodiscard]] double peak() const { return peak_; }
+    [[nodiscard]] double drawdown() const { return peak_ > 0 ? 1.0 - equity_ / peak_ : 0.0; }
+    [[nodiscard]] double maxDrawdown() const { return maxDrawdown_; }
+    [[nodiscard]] std::size_t bars() const { return bars_; }
+
+    [[nodiscard]] RiskMetrics summarize() const {
+        RiskMetrics m;
+        m.finalEquity = equity_;
+        m.bars = bars_;
+        m.maxDrawdown = maxDrawdown_;
+        m.totalReturn = initialEquity_ != 0.0 ? equity_ / initialEquity_ - 1.0 : 0.0;
+        if (bars_ == 0) return m;
+
+        m.exposure = static_cast<double>(exposedBars_) / static_cast<double>(bars_);
+        m.turnover = equityStats_.mean() > 0 ? traded_ / equityStats_.mean() : 0.0;
+        if (bars_ < 2 || lastTimestamp_ <= firstTimestamp_) return m;
+
+        const double span = static_cast<double>(lastTimestamp_ - firstTimestamp_);
+        const double periodsPerYear = kMillisPerYear * static_cast<double>(bars_ - 1) / span;
+        const double scale = std::sqrt(periodsPerYear);
+        const double growth = initialEquity_ > 0 ? equity_ / initialEquity_ : 0.0;
+        m.annualReturn = growth > 0 ? std::pow(growth, kMillisPerYear / span) - 1.0 : -1.0;
+        m.volatility = returns_.stdDev() * scale;
+        m.sharpe = sharpe(returns_.mean(), returns_.stdDev()) * scale;
+
+        const double downside = std::sqrt(downsideSq_ / static_cast<double>(returns_.count()));
+        m.sortino = downside > 0 ? returns_.mean() / downside * scale : 0.0;
+        m.calmar = maxDrawdown_ > 0 ? m.annualReturn / maxDrawdown_ : 0.0;
+        return m;
+    }
+
+private:
+    double initialEquity_;
+    double equity_;
+    double peak_;
+    double maxDrawdown_{0.0};
+    RunningStats returns_;
+    RunningStats equityStats_;
+    double downsideSq_{0.0};
+    double traded_{0.0};
+    std::size_t exposedBars_{0};
+    std::size_t bars_{0};
+    std::int64_t firstTimestamp_{0};
+    std::int64_t lastTimestamp_{0};
+};
+
+} // namespace metrics
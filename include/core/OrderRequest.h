@@ -4,6 +4,13 @@
 
 enum class Side { Long, Short };
 
+// Market orders fill at the bar close. The others rest in the engine's order
+// book until the intrabar price path reaches them:
+//   Limit     - long fills at or below limitPrice, short at or above it
+//   Stop      - long fills once price rises to stopPrice, short once it falls to it
+//   StopLimit - becomes a Limit order at limitPrice once stopPrice is reached
+enum class OrderType { Market, Limit, Stop, StopLimit };
+
 struct OrderRequest {
     Side   side{Side::Long};
     double sizeUsd{0.0};     // position notional in USD
@@ -11,4 +18,10 @@ struct OrderRequest {
     double leverage{1.0};
     double stopLossPrice{0.0};
     double takeProfitPrice{0.0};
-}; 
\ No newline at end of file
+
+    OrderType type{OrderType::Market};
+    double limitPrice{0.0};
+    double stopPrice{0.0};
+    std::int64_t expiryTimestamp{0}; // resting orders: cancelled after this time (ms); 0 = good till cancelled
+    std::uint64_t id{0};             // resting orders: key for cancel/replace; 0 = assigned by the engine
+};
@@ -3,11 +3,15 @@
 #include "core/Trade.h"
 
 struct Position {
+    std::uint64_t id{0};         // unique per engine, increasing in opening order
     Side   side{Side::Long};
     double entryPrice{0.0};
     std::int64_t entryTimestamp{0};
     double sizeAmount{0.0};
     double leverage{1.0};
+    double margin{0.0};          // collateral held: entry notional / leverage
     double stopLossPrice{0.0};
     double takeProfitPrice{0.0};
+    double fee{0.0};             // entry fee, charged when the position closes
+    double funding{0.0};         // funding accrued so far (negative if received)
 }; 
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "core/Account.h"
+
+// Machine-readable backtest results, for orchestration that would otherwise
+// scrape the console summary.
+//
+// Every document is built in memory and written with a single write per file
+// (to a temp file, then renamed), so a finished run costs one syscall burst
+// and readers never see a partial file. JSON is compact and columnar: trades
+// and the equity curve are objects of equal-length arrays, not arrays of
+// objects. The CSV files carry the same columns, one row per trade, mark or
+// sweep run.
+namespace results {
+
+// Identifies a run in its output.
+struct RunInfo {
+    std::string label;                        // e.g. strategy and symbol
+    std::map<std::string, double> parameters; // e.g. swept parameter values
+};
+
+// One row of a sweep: the parameters that were run and their outcome.
+struct SweepRow {
+    std::map<std::string, double> parameters;
+    AccountSummary summary;
+};
+
+// {"label", "parameters", "summary", "risk", "trades", "equity"}; "equity" is
+// present only if the account recorded its curve.
+std::string toJson(const Account& account, const RunInfo& info = {});
+
+// side,entry_timestamp,entry_price,exit_timestamp,exit_price,size,pnl,fee,funding
+std::string tradesCsv(const Account& account);
+
+// timestamp,equity,drawdown
+std::string equityCsv(const Account& account);
+
+// JSON array of {"parameters", "summary", "risk"}, and the same as CSV with one
+// column per parameter followed by the summary columns.
+std::string sweepJson(const std::vector<SweepRow>& rows);
+std::string sweepCsv(const std::vector<SweepRow>& rows);
+
+// Writes contents to path atomically; throws std::runtime_error on failure.
+void writeFile(const std::string& path, const std::string& contents);
+
+// Writes <base>.json, <base>.trades.csv and, if recorded, <base>.equity.csv.
+void writeRun(const std::string& base, const Account& account, const RunInfo& info = {});
+
+// Writes <base>.json and <base>.csv.
+void writeSweep(const std::string& base, const std::vector<SweepRow>& rows);
+
+} // namespace results
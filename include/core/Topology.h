@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// CPU/NUMA layout of the machine and thread pinning.
+//
+// On a multi-socket box each socket's cores read their own node's memory
+// fastest; threads that drift between sockets, or read bars first touched on
+// the other socket, pay for every cache miss twice. The pool can pin its
+// workers through this interface and runners can replicate read-only inputs
+// per node (see engine/NumaReplicated.h). Pinning is Linux-only; elsewhere
+// detect() reports a single node and pinCurrentThread() returns false.
+namespace topology {
+
+// Parses a sysfs CPU list such as "0-3,8-11" (whitespace-trimmed, may be
+// empty). Throws std::invalid_argument on malformed input.
+std::vector<int> parseCpuList(std::string_view list);
+
+struct Node {
+    int id{0};             // kernel node id (nodeN)
+    std::vector<int> cpus; // CPUs this process may run on, ascending
+};
+
+// Where one worker runs: a CPU and the index of its node in Topology::nodes().
+struct Placement {
+    int cpu{0};
+    std::size_t node{0};
+};
+
+class Topology {
+public:
+    explicit Topology(std::vector<Node> nodes);
+
+    // Reads <sysfsRoot>/node*/cpulist, keeping only CPUs in `allowed` and
+    // nodes left with at least one CPU. Without NUMA information the result
+    // is one node holding every allowed CPU.
+    static Topology fromSysfs(const std::string& sysfsRoot, const std::vector<int>& allowed);
+
+    // fromSysfs() over /sys/devices/system/node and this process's affinity mask.
+    static Topology detect();
+
+    // detect() on the live system, computed once.
+    static const Topology& system();
+
+    [[nodiscard]] const std::vector<Node>& nodes() const { return nodes_; }
+    [[nodiscard]] std::size_t nodeCount() const { return nodes_.size(); }
+    [[nodiscard]] std::size_t cpuCount() const;
+
+    // Placement of worker `index`: workers are dealt round-robin across the
+    // nodes, then across each node's CPUs, so any worker count is spread
+    // evenly over the sockets and no CPU is reused before all are taken.
+    [[nodiscard]] Placement place(std::size_t index) const;
+
+private:
+    std::vector<Node> nodes_;
+};
+
+// Pins the calling thread to placement.cpu and records placement.node for
+// currentNode(). Returns false if pinning is unsupported or refused; the
+// node is recorded either way.
+bool pinCurrentThread(const Placement& placement);
+
+// Node index recorded by the last pinCurrentThread() on this thread; 0 for
+// threads that were never pinned.
+std::size_t currentNode();
+
+} // namespace topology
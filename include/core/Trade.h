@@ -13,6 +13,7 @@ struct Trade {
     double exitPrice{0.0};
     
     double sizeAmount{0.0};
-    double pnl{0.0};
-    double fee{0.0};
+    double pnl{0.0};      // net of fees and funding
+    double fee{0.0};      // entry plus exit fees
+    double funding{0.0};  // funding paid while held (negative if received)
 }; 
\ No newline at end of file
@@ -1,16 +1,84 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
 #include <vector>
 #include "core/Bar.h"
+#include "core/BarSeries.h"
+#include "data/PriceSource.h"
 
-// Simple N-minute bar aggregator (placeholder)
+// Simple N-minute bar aggregator
 class Aggregator {
 public:
-    explicit Aggregator(std::size_t resolutionMinutes) : resolution_{resolutionMinutes} {}
+    explicit Aggregator(std::size_t resolutionMinutes);
 
     std::vector<Bar> aggregate(const std::vector<Bar>& raw) const;
 
+    // Column-wise equivalent of aggregate(): finds each bucket's extent from the
+    // timestamp column, then reduces the high/low/volume/trade columns over it.
+    BarSeries aggregate(const BarSeries& raw) const;
+
+    // Streaming interface: feed bars in time order. Returns true and sets
+    // completed when bar starts a new bucket and thereby closes the previous one.
+    bool push(const Bar& bar, Bar& completed);
+
+    // Emits the bucket still being built, if any. Call once the input is exhausted.
+    bool flush(Bar& completed);
+
 private:
+    struct State {
+        Bar current;
+        long nextTimestampBoundary{0};
+    };
+
+    static bool step(State& state, const Bar& bar, long resolutionMillis, Bar& completed);
+
     std::size_t resolution_;
-}; 
\ No newline at end of file
+    State state_;
+};
+
+// Wraps a PriceSource and streams its bars aggregated to a coarser resolution,
+// pulling from the upstream source in fixed-size batches.
+class AggregatedPriceSource : public PriceSource {
+public:
+    AggregatedPriceSource(std::shared_ptr<PriceSource> upstream, std::size_t resolutionMinutes,
+                          std::size_t batchSize = 4096);
+
+    std::vector<Bar> fetch() override;
+
+    std::size_t next_batch(std::span<Bar> out) override;
+
+private:
+    std::shared_ptr<PriceSource> upstream_;
+    Aggregator aggregator_;
+    std::vector<Bar> input_;
+    std::size_t inputSize_{0};
+    std::size_t inputPos_{0};
+    bool exhausted_{false};
+};
+
+// Maintains several resolutions of the same symbol in one pass over the input.
+// Feed 1-minute bars (one at a time or in batches); each time a bucket closes,
+// onBar is called with its resolution and the completed bar, so no resolution
+// needs its own scan of the raw data or its own full output vector.
+class MultiResolutionAggregator {
+public:
+    using Callback = std::function<void(std::size_t resolutionMinutes, const Bar& bar)>;
+
+    MultiResolutionAggregator(std::vector<std::size_t> resolutionsMinutes, Callback onBar);
+
+    void push(const Bar& bar);
+    void push(std::span<const Bar> bars);
+
+    // Emits the partially built bucket of every resolution. Call at end of input.
+    void flush();
+
+    [[nodiscard]] const std::vector<std::size_t>& resolutions() const { return resolutions_; }
+
+private:
+    std::vector<std::size_t> resolutions_;
+    std::vector<Aggregator> aggregators_;
+    Callback onBar_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/Bar.h"
+#include "core/BarSeries.h"
+
+// Versioned binary columnar bar file, used as the local price cache.
+//
+// Layout (little-endian):
+//   Header (64 bytes), then seven fixed-width columns of `count` elements each,
+//   in this order: timestamp (i64), open, high, low, close, volume (f64), num_trades (i64).
+// Every column starts on an 8-byte boundary, so a mapped file can be read in place.
+namespace barfile {
+
+inline constexpr char kMagic[4] = {'M', 'B', 'A', 'R'};
+inline constexpr std::uint32_t kVersion = 1;
+inline constexpr std::uint32_t kColumnCount = 7;
+
+enum Column : std::uint32_t { Timestamp = 0, Open, High, Low, Close, Volume, NumTrades };
+
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t count;          // number of bars
+    std::uint32_t columnCount;
+    std::uint32_t reserved0;
+    std::uint64_t checksum;       // checksum() of the column payload
+    std::uint64_t reserved[4];
+};
+static_assert(sizeof(Header) == 64, "bar file header must stay 64 bytes");
+
+// Byte offset of a column's first element from the start of the file.
+inline std::uint64_t columnOffset(std::uint64_t count, Column column) {
+    return sizeof(Header) + static_cast<std::uint64_t>(column) * count * sizeof(std::uint64_t);
+}
+
+// Expected total file size for `count` bars.
+inline std::uint64_t fileSize(std::uint64_t count) {
+    return columnOffset(count, Column::Timestamp) + kColumnCount * count * sizeof(std::uint64_t);
+}
+
+inline constexpr std::uint64_t kChecksumSeed = 0xcbf29ce484222325ULL;
+
+// FNV-1a style hash over 64-bit words of the column payload. Passing the result
+// of a previous call as seed continues the hash, so columns held in separate
+// buffers hash the same as the contiguous payload.
+std::uint64_t checksum(const void* payload, std::uint64_t sizeBytes, std::uint64_t seed = kChecksumSeed);
+
+// Validates a header against the file size; throws std::runtime_error on mismatch.
+void validateHeader(const Header& header, std::uint64_t actualFileSize, const std::string& path);
+
+// Writes bars atomically (temp file + rename), so concurrent readers never see a partial file.
+void write(const std::string& path, const std::vector<Bar>& bars);
+void write(const std::string& path, const BarSeries& series);
+
+// Reads and verifies a bar file; throws std::runtime_error if it is missing, truncated,
+// from an unknown version, or fails the checksum.
+std::vector<Bar> read(const std::string& path);
+
+// Same as read(), but loads each column straight into a BarSeries without transposing.
+BarSeries readSeries(const std::string& path);
+
+} // namespace barfile
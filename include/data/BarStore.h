@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/Bar.h"
+
+// Persistent per-symbol bar store, partitioned by UTC day:
+//
+//   <root>/<symbol>/<resolution>/YYYY-MM-DD.bin   (data/BarFile.h format)
+//
+// A partition file holds every bar of its day, or none if the sources had
+// no data for that day, so its presence means "this day is cached". Any
+// request range is then served from the partitions it overlaps, and only the
+// days without a file need fetching, however the range was requested before.
+//
+// Range bounds are Unix seconds, inclusive at both ends like the remote
+// sources; bar timestamps are milliseconds.
+class BarStore {
+public:
+    static constexpr long kPartitionSeconds = 24 * 60 * 60;
+
+    // How long after a day ends before it is stored. Providers publish the
+    // last bars of a day with some lag; a day fetched just after midnight
+    // could otherwise be cached with its final minutes missing, for good.
+    static constexpr long kSettleSeconds = 60 * 60;
+
+    BarStore(std::string root, const std::string& symbol, std::string resolution);
+
+    // Start of the day partition containing `seconds`.
+    static long partitionStart(long seconds);
+
+    // Starts of the partitions overlapping [from, to], ascending.
+    static std::vector<long> partitionsFor(long from, long to);
+
+    std::string partitionPath(long start) const;
+    bool hasPartition(long start) const;
+
+    // Partitions overlapping [from, to] with no file yet, merged into
+    // contiguous [first, last] second ranges aligned to whole days.
+    std::vector<std::pair<long, long>> missingRanges(long from, long to) const;
+
+    // Writes one file per partition lying entirely inside [from, to] that
+    // ended at least kSettleSeconds before `now` (a day still in progress, or
+    // only just over, would be cached incomplete). Days in the range without
+    // bars get an empty file. Returns the number of partitions written.
+    std::size_t store(const std::vector<Bar>& bars, long from, long to, long now = std::time(nullptr)) const;
+
+    // Bars with timestamps in [from, to] from the partitions present on disk,
+    // in timestamp order. Throws std::runtime_error on an unreadable file,
+    // unless `unreadable` is given: then a corrupt or truncated partition is
+    // deleted (so it reads as missing again) and its start appended there.
+    std::vector<Bar> load(long from, long to, std::vector<long>* unreadable = nullptr) const;
+
+private:
+    std::string dir_; // <root>/<symbol>/<resolution>
+};
@@ -1,25 +1,45 @@
 #pragma once
 
+#include "data/HttpClient.h"
 #include "data/PriceSource.h"
-#include <string>
+#include "data/SegmentPrefetcher.h"
 #include <map>
+#include <memory>
+#include <string>
+#include <utility>
 
 // Fetches price data from the Binance Futures API for volume and trades data.
 class BinancePriceSource : public PriceSource {
 public:
-    BinancePriceSource(std::string symbol, std::string resolution, long from, long to);
+    static constexpr const char* kDefaultBaseUrl = "https://fapi.binance.com";
+
+    // baseUrl can point at a mirror or a local test server.
+    BinancePriceSource(std::string symbol, std::string resolution, long from, long to,
+                       std::string baseUrl = kDefaultBaseUrl);
 
     std::vector<Bar> fetch() override;
 
+    // Rate limits and retry policy for the shared HttpClient of this API.
+    static HttpClient::Config httpConfig();
+
+    // Streams segment by segment; the next segment downloads while the current one is consumed.
+    std::size_t next_batch(std::span<Bar> out) override;
+
 private:
     std::string symbol_;
     std::string resolution_;
     long from_;
     long to_;
-    const std::string baseUrl_ = "https://fapi.binance.com";
+    std::string baseUrl_;
+    std::shared_ptr<HttpClient> http_; // shared by every source using baseUrl_
+
+    std::unique_ptr<SegmentPrefetcher> stream_;
+
+    // Splits [from_, to_) into request-sized segments for the configured resolution.
+    std::vector<std::pair<long, long>> planSegments() const;
 
-    // Fetches a single segment of data, respecting rate limits.
-    std::vector<Bar> fetchSegment(long from, long to, bool addDelay);
+    // Fetches a single segment of data; http_ handles rate limits and retries.
+    std::vector<Bar> fetchSegment(long from, long to);
 
     // Helper to facilitate testing of the parsing logic
     static std::vector<Bar> parseJsonResponse(const std::string& jsonBody);
@@ -32,14 +52,6 @@ private:
 
     // Resolution-based chunking limits (in seconds) - Binance allows up to 1000 candles per request
     static const std::map<int, long> RESOLUTION_LIMITS;
-    
-    // Retry configuration - increased delays to handle IP bans
-    static const int MAX_RETRIES = 3;
-    static const int INITIAL_RETRY_DELAY_MS = 30000; // 30 seconds for IP ban recovery
-    static const int MAX_RETRY_DELAY_MS = 300000; // 5 minutes maximum delay
-    
-    // Helper method for retrying failed requests
-    std::vector<Bar> fetchSegmentWithRetry(long from, long to, int retryCount = 0);
 
     // Give test class access to private members
     friend class BinancePriceSourceTest;
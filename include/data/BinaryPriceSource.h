@@ -0,0 +1,15 @@
+#pragma once
+
+#include "data/PriceSource.h"
+#include <string>
+
+// Reads bars from a binary columnar bar file (see data/BarFile.h).
+class BinaryPriceSource : public PriceSource {
+public:
+    explicit BinaryPriceSource(std::string path);
+
+    std::vector<Bar> fetch() override;
+
+private:
+    std::string path_;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "core/Bar.h"
+
+// In-place CSV parsing for bar files of the form
+//   timestamp,open,high,low,close,volume[,num_trades]
+// Fields are split without copying and converted with std::from_chars, which is
+// locale-independent and allocation-free.
+namespace csv {
+
+// Returns text with its first line (the header) removed.
+std::string_view skipHeader(std::string_view text);
+
+// Rough row count for a buffer, from its size and the length of its first line.
+std::size_t estimateRows(std::string_view body);
+
+// Parses every line of body (no header) and appends the bars to out. A final
+// line without a trailing newline is parsed too; blank lines are skipped.
+// num_trades is optional and defaults to 0. Throws std::runtime_error on malformed input.
+void parseBars(std::string_view body, std::vector<Bar>& out);
+
+// Streaming variant: parses whole lines from the front of text into out, stopping
+// when out is full or text runs out. A trailing line without '\n' is only parsed
+// if atEof. Sets consumed to the number of bytes used and returns the bar count.
+std::size_t parseLines(std::string_view text, std::span<Bar> out, bool atEof, std::size_t& consumed);
+
+// Splits body into at most maxChunks pieces of roughly equal size. Every cut is
+// placed just after a newline, so each chunk holds whole lines only.
+std::vector<std::string_view> splitChunks(std::string_view body, std::size_t maxChunks);
+
+} // namespace csv
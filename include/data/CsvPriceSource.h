@@ -1,14 +1,43 @@
 #pragma once
 
 #include "data/PriceSource.h"
+#include <cstddef>
+#include <fstream>
 #include <string>
+#include <string_view>
+#include <thread>
 
 class CsvPriceSource : public PriceSource {
 public:
-    explicit CsvPriceSource(std::string csvPath);
+    // Files of at least kParallelThresholdBytes are split at line boundaries and
+    // parsed on up to threadCount threads.
+    static constexpr std::size_t kParallelThresholdBytes = 8 * 1024 * 1024;
+    static constexpr std::size_t kStreamBlockBytes = 1024 * 1024;
+
+    explicit CsvPriceSource(std::string csvPath,
+                            std::size_t threadCount = std::thread::hardware_concurrency());
 
     std::vector<Bar> fetch() override;
 
+    // Streams the file in kStreamBlockBytes reads; memory stays bounded by one block.
+    std::size_t next_batch(std::span<Bar> out) override;
+
+    // Exports bars in the same format fetch() reads:
+    // timestamp,open,high,low,close,volume,num_trades
+    static void write(const std::string& csvPath, const std::vector<Bar>& bars);
+
 private:
     std::string path_;
+    std::size_t threadCount_;
+
+    std::vector<Bar> parseParallel(std::string_view body) const;
+
+    // Streaming state for next_batch()
+    std::ifstream stream_;
+    std::string pending_;
+    std::size_t pendingPos_{0};
+    bool headerSkipped_{false};
+    bool eof_{false};
+
+    void refill();
 }; 
\ No newline at end of file
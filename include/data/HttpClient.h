@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cpr/cpr.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "data/RateLimiter.h"
+
+// Rate-limited, retrying GET client for one API host.
+//
+// Requests reuse idle cpr::Sessions, so the underlying connection stays open
+// (keep-alive) across segments instead of a new TCP/TLS handshake per call;
+// each concurrent request borrows its own session. Every request first takes
+// its weight from the host's RateLimiter. 429 (rate limited) and 418 (IP ban)
+// pause the limiter for Retry-After, or the current backoff if the header is
+// missing, and 5xx or transport errors back off exponentially; any other
+// non-200 status fails at once.
+class HttpClient {
+public:
+    struct Config {
+        double capacity{1200.0};                          // request weight per window
+        std::chrono::milliseconds window{std::chrono::minutes{1}};
+        std::string usedWeightHeader;                     // server-reported usage, e.g. X-MBX-USED-WEIGHT-1M
+        int maxAttempts{5};
+        std::chrono::milliseconds initialBackoff{std::chrono::seconds{1}};
+        std::chrono::milliseconds maxBackoff{std::chrono::minutes{1}};
+        std::chrono::milliseconds timeout{std::chrono::seconds{30}};
+
+        bool operator==(const Config&) const = default;
+    };
+
+    HttpClient(std::string baseUrl, const Config& config);
+
+    // The process-wide client for baseUrl and config, created on first use.
+    // Every source using the same host and limits shares one limiter and
+    // session pool; a different config (another API's limits on the same
+    // host, e.g. a local mirror of both) gets a client of its own.
+    static std::shared_ptr<HttpClient> shared(const std::string& baseUrl, const Config& config);
+
+    // GETs baseUrl + path. Returns the 200 response; throws std::runtime_error
+    // ("HTTP <status> ...") once retries are exhausted or on a non-retryable status.
+    cpr::Response get(const std::string& path, const cpr::Parameters& parameters, double weight = 1.0);
+
+    [[nodiscard]] RateLimiter& limiter() { return limiter_; }
+    [[nodiscard]] const std::string& baseUrl() const { return baseUrl_; }
+
+private:
+    std::unique_ptr<cpr::Session> takeSession();
+    void returnSession(std::unique_ptr<cpr::Session> session);
+
+    const std::string baseUrl_;
+    const Config config_;
+    RateLimiter limiter_;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<cpr::Session>> idle_;
+};
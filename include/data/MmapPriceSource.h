@@ -0,0 +1,67 @@
+#pragma once
+
+#include "data/PriceSource.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+// Zero-copy, read-only view over the columns of a bar file (see data/BarFile.h).
+struct BarColumnsView {
+    std::span<const std::int64_t> timestamp;
+    std::span<const double> open;
+    std::span<const double> high;
+    std::span<const double> low;
+    std::span<const double> close;
+    std::span<const double> volume;
+    std::span<const std::int64_t> num_trades;
+
+    [[nodiscard]] std::size_t size() const { return timestamp.size(); }
+    [[nodiscard]] bool empty() const { return timestamp.empty(); }
+
+    // Assembles row i. Cheap (seven loads), but prefer the columns for scans.
+    [[nodiscard]] Bar operator[](std::size_t i) const {
+        return Bar{timestamp[i], open[i], high[i], low[i], close[i], volume[i], num_trades[i]};
+    }
+};
+
+// A bar file mapped read-only into memory. The mapping is MAP_SHARED, so every
+// process mapping the same file shares its physical pages through the page cache.
+// Within a process, open() hands out one mapping per file to all callers.
+class MappedBarFile {
+public:
+    // Returns the process-wide mapping for path, creating it if needed.
+    // The checksum is verified once, when the mapping is first created.
+    static std::shared_ptr<const MappedBarFile> open(const std::string& path);
+
+    ~MappedBarFile();
+
+    MappedBarFile(const MappedBarFile&) = delete;
+    MappedBarFile& operator=(const MappedBarFile&) = delete;
+
+    [[nodiscard]] const BarColumnsView& view() const { return view_; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+
+private:
+    explicit MappedBarFile(std::string path);
+
+    std::string path_;
+    void* data_{nullptr};
+    std::size_t size_{0};
+    std::uint64_t fileId_{0}; // inode, to detect a cache file replaced on disk
+    BarColumnsView view_;
+};
+
+class MmapPriceSource : public PriceSource {
+public:
+    explicit MmapPriceSource(std::string path);
+
+    // Materializes a copy of the bars, for consumers that need a std::vector<Bar>.
+    std::vector<Bar> fetch() override;
+
+    // Zero-copy access to the mapped columns; valid as long as this source lives.
+    [[nodiscard]] const BarColumnsView& view() const { return file_->view(); }
+
+private:
+    std::shared_ptr<const MappedBarFile> file_;
+};
@@ -1,28 +1,62 @@
 #pragma once
 
 #include "core/Bar.h"
+#include "data/BinancePriceSource.h"
+#include "data/PythPriceSource.h"
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
-// Orchestrates loading of price data, using a local CSV cache
-// and falling back to remote APIs if the cache is empty.
+// Orchestrates loading of price data from a local day-partitioned bar store
+// (see data/BarStore.h), fetching only the days it does not hold yet from the
+// remote APIs. Legacy exact-range caches (<symbol>_<res>_<from>_<to>.bin or
+// .csv) are still read first when present.
 // Combines OHLC data from Pyth with volume and num_trades from Binance.
 class PriceManager {
 public:
-    PriceManager(std::string symbol, std::string resolution, long from, long to);
-    
+    // Fetches bars for [from, to] (Unix seconds, inclusive) from the remote sources.
+    using Fetcher = std::function<std::vector<Bar>(long from, long to)>;
+
+    // Base URLs of the remote sources; tests point them at a local server.
+    struct Endpoints {
+        std::string pyth = PythPriceSource::kDefaultBaseUrl;
+        std::string binance = BinancePriceSource::kDefaultBaseUrl;
+    };
+
+    // An empty fetcher means Pyth + Binance.
+    PriceManager(std::string symbol, std::string resolution, long from, long to,
+                 std::string cacheDir = "./price_history/", Fetcher fetcher = {});
+
     std::vector<Bar> loadData();
 
+    void setEndpoints(Endpoints endpoints) { endpoints_ = std::move(endpoints); }
+
+    // Writes bars as CSV, e.g. for inspection or for tools that expect the old cache format.
+    static void exportCsv(const std::vector<Bar>& bars, const std::string& csvPath);
+
 private:
     std::string symbol_;
     std::string resolution_;
     long from_;
     long to_;
-    const std::string priceHistoryPath_ = "./price_history/";
+    std::string priceHistoryPath_;
+    Fetcher fetcher_;
+    Endpoints endpoints_;
 
+    std::string getCacheBaseName() const;
     std::string getCsvPath() const;
-    void cacheDataToCsv(const std::vector<Bar>& bars) const;
-    
-    // Combine OHLC data from Pyth with volume/trades data from Binance
-    std::vector<Bar> combineData(const std::vector<Bar>& pythBars, const std::vector<Bar>& binanceBars) const;
-}; 
\ No newline at end of file
+    std::string getBinaryPath() const;
+    void cacheData(const std::vector<Bar>& bars) const;
+
+    // Serves [from_, to_] from the bar store, fetching the missing days first.
+    std::vector<Bar> loadFromStore();
+
+    // Pyth OHLC combined with Binance volume for [from, to]. Both sources
+    // (each with its own segment pool) download concurrently.
+    std::vector<Bar> fetchRemote(long from, long to) const;
+
+    // Combine OHLC data from Pyth with volume/trades data from Binance.
+    // Both inputs are sorted by timestamp without duplicates, as fetch() returns them.
+    static std::vector<Bar> combineData(const std::vector<Bar>& pythBars, const std::vector<Bar>& binanceBars);
+};
@@ -1,12 +1,39 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <vector>
 #include "core/Bar.h"
 
 class PriceSource {
 public:
     virtual ~PriceSource() = default;
- // ... existing code ...
-    virtual std::vector<Bar> fetch() = 0;  // blocking fetch of full dataset for now
-};
\ No newline at end of file
+
+    // Blocking fetch of the full dataset.
+    virtual std::vector<Bar> fetch() = 0;
+
+    // Incremental interface: writes the next bars (in time order) into out and
+    // returns how many were written. 0 means the source is exhausted. Consumers
+    // can start processing as soon as the first batch arrives, with memory bounded
+    // by the batch size rather than the whole range.
+    //
+    // The default implementation calls fetch() once and serves the result in
+    // batches; sources that can stream (files, paged APIs) override it.
+    virtual std::size_t next_batch(std::span<Bar> out) {
+        if (!fetched_) {
+            buffered_ = fetch();
+            fetched_ = true;
+        }
+        std::size_t n = 0;
+        while (n < out.size() && cursor_ < buffered_.size()) {
+            out[n++] = buffered_[cursor_++];
+        }
+        return n;
+    }
+
+private:
+    std::vector<Bar> buffered_;
+    std::size_t cursor_{0};
+    bool fetched_{false};
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Token bucket shared by every request to one API.
+//
+// The bucket holds up to `capacity` tokens and refills continuously at
+// capacity per `window`, matching limits such as Binance's "2400 request
+// weight per minute". A request takes its cost in tokens and blocks only as
+// long as the bucket is short, so bursts run at full speed and sustained
+// load settles at the allowed rate with no fixed sleeps. The server's own
+// view can tighten it: observeUsed() applies a reported usage (e.g.
+// X-MBX-USED-WEIGHT-1M) and pauseFor() honours a 429/418 Retry-After.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Throws std::invalid_argument unless capacity and window are positive.
+    RateLimiter(double capacity, std::chrono::milliseconds window);
+
+    // Blocks until `cost` tokens are available and any pause has ended, then
+    // takes them. A cost above capacity is clamped to capacity.
+    void acquire(double cost = 1.0);
+
+    // The server reports `used` of the window's capacity as spent; the bucket
+    // keeps no more than what is left.
+    void observeUsed(double used);
+
+    // Nobody acquires before `delay` has passed, and the bucket restarts empty.
+    void pauseFor(std::chrono::milliseconds delay);
+
+    // Tokens available right now.
+    [[nodiscard]] double available();
+
+    [[nodiscard]] double capacity() const { return capacity_; }
+
+private:
+    void refill(Clock::time_point now);
+
+    const double capacity_;
+    const double perSecond_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    double tokens_;
+    Clock::time_point lastRefill_;
+    Clock::time_point pausedUntil_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+#include "core/Bar.h"
+
+// Streams bars from a paged remote API one segment at a time. While the caller
+// consumes segment k, up to `lookahead` following segments are already being
+// fetched in the background, so the first bars are available after a single
+// request and memory stays bounded by (1 + lookahead) segments.
+class SegmentPrefetcher {
+public:
+    using Segment = std::pair<long, long>; // [from, to) in epoch seconds
+    using FetchFn = std::function<std::vector<Bar>(long from, long to)>;
+
+    SegmentPrefetcher(std::vector<Segment> segments, FetchFn fetch, std::size_t lookahead = 1);
+
+    // Waits for any in-flight requests so none outlive the owning source.
+    ~SegmentPrefetcher();
+
+    SegmentPrefetcher(const SegmentPrefetcher&) = delete;
+    SegmentPrefetcher& operator=(const SegmentPrefetcher&) = delete;
+
+    // Same contract as PriceSource::next_batch. Bars are sorted per segment,
+    // and bars repeated across segment boundaries are dropped.
+    std::size_t next_batch(std::span<Bar> out);
+
+private:
+    std::vector<Segment> segments_;
+    FetchFn fetch_;
+    std::size_t lookahead_;
+
+    std::size_t nextToLaunch_{0};
+    std::deque<std::future<std::vector<Bar>>> inFlight_;
+
+    std::vector<Bar> current_;
+    std::size_t cursor_{0};
+    std::int64_t lastTimestamp_{std::numeric_limits<std::int64_t>::min()};
+
+    void launchAhead();
+};
@@ -1,21 +1,195 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
+#include "core/Log.h"
+#include "core/ResultsWriter.h"
 #include "engine/ExecutionEngine.h"
+#include "engine/NumaReplicated.h"
+#include "engine/ParameterGrid.h"
+#include "engine/ThreadPool.h"
+#include "data/Aggregator.h"
 #include "data/PriceSource.h"
 
+// How parallel runs (several strategies, sweeps) are placed on the machine.
+// The defaults are every core, unpinned, one shared copy of the bars.
+struct RunnerOptions {
+    std::size_t threads{std::thread::hardware_concurrency()};
+    bool pinThreads{false};       // see PoolOptions::pinThreads
+    bool replicatePerNode{false}; // one copy of the bars per NUMA node; needs pinThreads
+
+    [[nodiscard]] PoolOptions pool(std::size_t tasks) const {
+        return {std::max<std::size_t>(1, std::min(threads, tasks)), pinThreads};
+    }
+};
+
+// One row of a parameter sweep: the combination that was run and its outcome.
+struct SweepResult {
+    std::size_t index{0}; // combination index within the ParameterGrid
+    StrategyConfig config;
+    AccountSummary summary;
+};
+
 class BacktestManager {
 public:
     BacktestManager(std::shared_ptr<PriceSource> src, std::shared_ptr<IStrategy> strat)
-        : priceSrc_{std::move(src)}, strategy_{std::move(strat)} {}
+        : priceSrc_{std::move(src)}, strategies_{std::move(strat)} {}
+
+    // Runs every strategy against the same bars. Each strategy gets its own
+    // ExecutionEngine, and the engines are spread across a thread pool.
+    BacktestManager(std::shared_ptr<PriceSource> src,
+                    std::vector<std::shared_ptr<IStrategy>> strats,
+                    RunnerOptions options = {})
+        : priceSrc_{std::move(src)}, strategies_{std::move(strats)}, options_{options} {}
 
     void run() {
+        if (strategies_.size() == 1) {
+            ExecutionEngine engine{strategies_.front()};
+            if (strategies_.front()->supportsBatch()) {
+                // Batch strategies need the whole series to compute signal windows.
+                engine.run(BarSeries::fromBars(priceSrc_->fetch()));
+            } else {
+                // Bar-by-bar strategies can stream straight from the source.
+                engine.run(*priceSrc_);
+            }
+            return;
+        }
         auto raw = priceSrc_->fetch();
-        ExecutionEngine engine{strategy_};
-        engine.run(raw);
+        runAll(raw, strategies_, options_);
+    }
+
+    // A single strategy runs inline on the calling thread; several strategies
+    // run concurrently, one engine per index of a parallel_for, sharing the
+    // read-only bars (or their copy on the worker's NUMA node). Engines only
+    // run on pool workers, never on the unpinned caller, so with
+    // options.pinThreads every replicas.local() is the copy of the node the
+    // engine runs on.
+    static void runAll(const std::vector<Bar>& bars,
+                       const std::vector<std::shared_ptr<IStrategy>>& strategies,
+                       const RunnerOptions& options = {}) {
+        if (strategies.size() == 1) {
+            ExecutionEngine engine{strategies.front()};
+            engine.run(bars);
+            return;
+        }
+
+        ThreadPool pool{options.pool(strategies.size())};
+        const NumaReplicated<std::vector<Bar>> replicas{bars, options.pinThreads && options.replicatePerNode};
+
+        pool.parallel_for(0, strategies.size(), [&replicas, &strategies](std::size_t i) {
+            ExecutionEngine engine{strategies[i]};
+            engine.run(replicas.local());
+        }, 1);
+    }
+
+    using StrategyCreator = std::function<std::shared_ptr<IStrategy>(const StrategyConfig&)>;
+    using SweepRanking = std::function<bool(const SweepResult&, const SweepResult&)>;
+
+    // Best net PnL first.
+    static bool byNetPnl(const SweepResult& a, const SweepResult& b) {
+        return a.summary.netPnl > b.summary.netPnl;
+    }
+
+    // Fetches and aggregates the bars once, then sweeps the grid over them.
+    std::vector<SweepResult> sweep(const ParameterGrid& grid,
+                                   const StrategyConfig& base,
+                                   const StrategyCreator& create,
+                                   std::size_t resolutionMinutes = 1,
+                                   const SweepRanking& rank = byNetPnl) const {
+        auto raw = priceSrc_->fetch();
+        auto bars = std::make_shared<const std::vector<Bar>>(
+            resolutionMinutes > 1 ? Aggregator{resolutionMinutes}.aggregate(raw) : std::move(raw));
+        return sweep(bars, grid, base, create, options_, rank);
+    }
+
+    // Runs one ExecutionEngine per grid combination across the pool, each
+    // writing its own slot of the result vector. The bars are converted to one
+    // immutable BarSeries that every run reads (one per NUMA node with
+    // options.replicatePerNode, read by pool workers only, as in runAll);
+    // results come back ranked.
+    static std::vector<SweepResult> sweep(std::shared_ptr<const std::vector<Bar>> bars,
+                                          const ParameterGrid& grid,
+                                          const StrategyConfig& base,
+                                          const StrategyCreator& create,
+                                          const RunnerOptions& options = {},
+                                          const SweepRanking& rank = byNetPnl) {
+        const BarSeries series = BarSeries::fromBars(*bars);
+        const std::size_t combinations = grid.size();
+        ThreadPool pool{options.pool(combinations)};
+        const NumaReplicated<BarSeries> replicas{series, options.pinThreads && options.replicatePerNode};
+
+        std::vector<SweepResult> results(combinations);
+        pool.parallel_for(0, combinations, [&grid, &base, &create, &replicas, &results](std::size_t i) {
+            SweepResult& result = results[i];
+            result.index = i;
+            result.config = grid.configAt(i, base);
+
+            ExecutionEngine engine{create(result.config), false};
+            engine.run(replicas.local());
+            result.summary = engine.account().summarize();
+        }, 1);
+        std::stable_sort(results.begin(), results.end(), rank);
+        return results;
+    }
+
+    // Prints the ranked result table, one row per combination.
+    static void printSweepResults(const std::vector<SweepResult>& results, const ParameterGrid& grid) {
+        logging::flush(); // earlier log lines first
+        std::cout << "\n--- Parameter Sweep Results (" << results.size() << " runs) ---\n";
+        std::cout << std::left << std::setw(6) << "Rank";
+        for (const auto& axis : grid.axes()) {
+            std::cout << std::setw(18) << axis.name;
+        }
+        std::cout << std::setw(14) << "Net PNL" << std::setw(8) << "Trades"
+                  << std::setw(10) << "Win %" << std::setw(10) << "Max DD %" << "Sharpe\n";
+
+        std::cout << std::fixed << std::setprecision(2);
+        for (std::size_t rank = 0; rank < results.size(); ++rank) {
+            const auto& r = results[rank];
+            std::cout << std::left << std::setw(6) << rank + 1;
+            for (const auto& axis : grid.axes()) {
+                std::cout << std::setw(18) << axisValue(r.config, axis.name);
+            }
+            std::cout << std::setw(14) << r.summary.netPnl << std::setw(8) << r.summary.totalTrades
+                      << std::setw(10) << r.summary.winRate * 100 << std::setw(10)
+                      << r.summary.risk.maxDrawdown * 100 << r.summary.risk.sharpe << "\n";
+        }
+    }
+
+    // Value of a grid axis (a StrategyConfig field or strategy param) in config.
+    static double axisValue(const StrategyConfig& config, const std::string& name) {
+        if (name == "initialCapital") return config.initialCapital;
+        if (name == "stopLossPercent") return config.stopLossPercent;
+        if (name == "takeProfitPercent") return config.takeProfitPercent;
+        if (name == "perTradeSize") return config.perTradeSize;
+        if (name == "maxOpenPositions") return static_cast<double>(config.maxOpenPositions);
+        return config.param(name, 0.0);
+    }
+
+    // Ranked sweep results as rows for results::writeSweep, one parameter per grid axis.
+    static std::vector<results::SweepRow> sweepRows(const std::vector<SweepResult>& ranked,
+                                                    const ParameterGrid& grid) {
+        std::vector<results::SweepRow> rows;
+        rows.reserve(ranked.size());
+        for (const auto& r : ranked) {
+            results::SweepRow row;
+            for (const auto& axis : grid.axes()) {
+                row.parameters[axis.name] = axisValue(r.config, axis.name);
+            }
+            row.summary = r.summary;
+            rows.push_back(std::move(row));
+        }
+        return rows;
     }
 
 private:
+
     std::shared_ptr<PriceSource> priceSrc_;
-    std::shared_ptr<IStrategy> strategy_;
-}; 
\ No newline at end of file
+    std::vector<std::shared_ptr<IStrategy>> strategies_;
+    RunnerOptions options_;
+};
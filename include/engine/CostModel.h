@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include "core/Bar.h"
+#include "core/OrderRequest.h"
+#include "strategy/StrategyConfig.h"
+
+// Whether a fill added liquidity (resting limit orders, take-profits) or took
+// it (market and stop orders, stop-losses, strategy exits at the close).
+enum class Liquidity { Maker, Taker };
+
+// Trading costs applied by the ExecutionEngine to every fill and to every bar
+// a position is held. Implementations are called from the bar loop, so they
+// must not allocate.
+class CostModel {
+public:
+    virtual ~CostModel() = default;
+
+    // Executed price for trading quantity units at the quoted price during bar.
+    // buy is the trade direction (opening a long or closing a short).
+    [[nodiscard]] virtual double fillPrice(bool buy, double price, double quantity, const Bar& bar,
+                                           Liquidity liquidity) const = 0;
+
+    // Fee charged on a fill of the given notional.
+    [[nodiscard]] virtual double fee(double notional, Liquidity liquidity) const = 0;
+
+    // Funding paid by a position of the given notional held over
+    // [from, to) (ms). Negative amounts are received.
+    [[nodiscard]] virtual double funding(Side side, double notional, std::int64_t from,
+                                         std::int64_t to) const = 0;
+};
+
+// Perpetual-futures costs from a CostConfig:
+//  - fees: notional * maker/taker rate;
+//  - slippage (taker fills only): slippageBps plus volumeImpact times the
+//    order's share of the bar's volume, against the trader;
+//  - funding: longs pay and shorts receive fundingRate per fundingIntervalHours,
+//    pro rata over the time held.
+class PerpCostModel final : public CostModel {
+public:
+    explicit PerpCostModel(const CostConfig& config) : config_{config} {}
+
+    [[nodiscard]] double fillPrice(bool buy, double price, double quantity, const Bar& bar,
+                                   Liquidity liquidity) const override {
+        if (liquidity == Liquidity::Maker) return price;
+        double slip = config_.slippageBps * 1e-4;
+        if (bar.volume > 0) {
+            slip += config_.volumeImpact * (quantity / bar.volume);
+        }
+        return buy ? price * (1.0 + slip) : price * (1.0 - slip);
+    }
+
+    [[nodiscard]] double fee(double notional, Liquidity liquidity) const override {
+        return notional * (liquidity == Liquidity::Maker ? config_.makerFeeRate : config_.takerFeeRate);
+    }
+
+    [[nodiscard]] double funding(Side side, double notional, std::int64_t from,
+                                 std::int64_t to) const override {
+        if (config_.fundingRate == 0.0 || to <= from || config_.fundingIntervalHours <= 0) return 0.0;
+        const double intervals = static_cast<double>(to - from) / (config_.fundingIntervalHours * 3'600'000.0);
+        const double paid = notional * config_.fundingRate * intervals;
+        return side == Side::Long ? paid : -paid;
+    }
+
+private:
+    CostConfig config_;
+};
@@ -2,60 +2,295 @@
 
 #include <memory>
 #include <vector>
-#include <iostream>
 #include <utility>
 #include <algorithm>
+#include <functional>
+#include <string>
+#include <span>
+#include <stdexcept>
 #include "core/Bar.h"
+#include "core/BarSeries.h"
 #include "core/Position.h"
 #include "core/Trade.h"
 #include "core/Account.h"
+#include "core/Log.h"
+#include "data/PriceSource.h"
+#include "engine/CostModel.h"
+#include "engine/LevelBook.h"
 #include "strategy/IStrategy.h"
-#include "engine/ThreadPool.h"
 
 class ExecutionEngine {
 public:
-    explicit ExecutionEngine(std::shared_ptr<IStrategy> strategy)
-        : strategy_{std::move(strategy)}, 
-          account_{strategy_->getConfig().initialCapital},
-          threadPool_{1} {}
+    // verbose=false suppresses per-trade log lines (emitted at debug level)
+    // and the end-of-run summary, for callers (e.g. parameter sweeps) that
+    // report results themselves.
+    explicit ExecutionEngine(std::shared_ptr<IStrategy> strategy, bool verbose = true)
+        : ExecutionEngine{strategy, std::make_shared<Account>(strategy->getConfig().initialCapital), verbose} {
+        marksAccount_ = true;
+    }
+
+    // Trades against an account shared with other engines (one per symbol in a
+    // PortfolioEngine). Entries are only filled while the account has enough
+    // free margin for them. The account's owner marks it to market (see
+    // openPnl()), since one engine only sees its own positions.
+    ExecutionEngine(std::shared_ptr<IStrategy> strategy, std::shared_ptr<Account> account, bool verbose = true)
+        : strategy_{std::move(strategy)},
+          account_{std::move(account)},
+          verbose_{verbose},
+          maxOpenPositions_{strategy_->getConfig().maxOpenPositions},
+          intrabarPath_{strategy_->getConfig().intrabarPath},
+          costs_{std::make_shared<PerpCostModel>(strategy_->getConfig().costs)} {
+        if (maxOpenPositions_ == 0) {
+            throw std::invalid_argument("maxOpenPositions must be at least 1.");
+        }
+        // Sized for the most positions the strategy may hold, so opening one
+        // never allocates mid-run.
+        positions_.reserve(maxOpenPositions_);
+        longStops_.reserve(maxOpenPositions_);
+        shortStops_.reserve(maxOpenPositions_);
+        longTargets_.reserve(maxOpenPositions_);
+        shortTargets_.reserve(maxOpenPositions_);
+    }
 
     void run(const std::vector<Bar>& bars) {
         if (bars.empty()) return;
+        if (strategy_->supportsBatch()) {
+            run(BarSeries::fromBars(bars));
+            return;
+        }
 
-        strategy_->on_start(bars.front(), account_.getBalance());
-
+        start(bars.front());
         for (const auto& bar : bars) {
-            checkSLTP(bar);
+            step(bar);
+        }
+        finish();
+    }
 
-            auto fut = threadPool_.enqueue([this, &bar] {
-                return strategy_->on_bar(bar, positions_, account_.getBalance());
-            });
-            auto action = fut.get();
-            
-            // Process close signals first
+    // Runs over a columnar series. Batch-capable strategies get whole windows
+    // through on_batch; others get each row assembled on the fly for on_bar.
+    void run(const BarSeries& series) {
+        if (series.empty()) return;
+        if (strategy_->supportsBatch()) {
+            runBatch(series);
+            return;
+        }
+
+        start(series.row(0));
+        for (std::size_t i = 0; i < series.size(); ++i) {
+            step(series.row(i));
+        }
+        finish();
+    }
+
+    // Streams bars from the source in batches of batchSize, so the first bar is
+    // processed as soon as the source delivers it and memory stays bounded by
+    // one batch regardless of the range length.
+    void run(PriceSource& source, std::size_t batchSize = 4096) {
+        std::vector<Bar> batch(std::max<std::size_t>(1, batchSize));
+        bool started = false;
+        while (const std::size_t n = source.next_batch(batch)) {
+            if (!started) {
+                start(batch.front());
+                started = true;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                step(batch[i]);
+            }
+        }
+        if (started) {
+            finish();
+        }
+    }
+
+    // Incremental driving, for callers that interleave several engines over
+    // one timeline (see PortfolioEngine): start() once with the first bar,
+    // step() every bar in time order, then stop().
+    void start(const Bar& firstBar) {
+        strategy_->on_start(firstBar, account_->getBalance());
+    }
+
+    void step(const Bar& bar) {
+        accrueFunding(bar);
+        expireOrders(bar.timestamp);
+        matchIntrabar(bar);
+
+        // Strategies are dispatched inline: a single strategy is inherently
+        // sequential, so handing each bar to a pool only adds latency.
+        // Parallelism lives one level up (see BacktestManager).
+        auto action = strategy_->on_bar(bar, positions_, account_->getBalance());
+
+        // Process close signals first
+        if (action.closeAllPositions) {
+            closeAll(bar);
+        } else {
+            for (const auto id : action.closePositionIds) {
+                closeById(id, bar.close, bar, Liquidity::Taker);
+            }
             if (action.closeCurrentPosition && !positions_.empty()) {
-                closePosition(0, bar.close, bar.timestamp);
+                closePosition(0, bar.close, bar, Liquidity::Taker);
             }
+        }
 
-            // Process open signals, only if no position is currently open
-            if (positions_.empty()) {
-                for (const auto& order : action.openRequests) {
-                    processOpenOrder(order, bar);
-                }
+        // Then order book maintenance
+        for (const auto id : action.cancelOrderIds) {
+            cancelOrder(id);
+        }
+        for (const auto& order : action.replaceRequests) {
+            if (!cancelOrder(order.id)) continue;
+            if (order.type != OrderType::Market) {
+                submitOrder(order);
+            } else if (positions_.size() < maxOpenPositions_) {
+                processOpenOrder(order, bar);
             }
         }
+
+        // Then new orders: market orders fill at the close while the book has
+        // room, the rest start resting from the next bar.
+        for (const auto& order : action.openRequests) {
+            if (order.type != OrderType::Market) {
+                submitOrder(order);
+            } else if (positions_.size() < maxOpenPositions_) {
+                processOpenOrder(order, bar);
+            }
+        }
+        markBar(bar);
+    }
+
+    void stop() {
         strategy_->on_finish();
-        account_.printSummary();
     }
 
+    [[nodiscard]] const Account& account() const { return *account_; }
+
+    [[nodiscard]] const std::vector<Position>& positions() const { return positions_; }
+
+    // Margin held by this engine's open positions.
+    [[nodiscard]] double usedMargin() const {
+        double margin = 0.0;
+        for (const auto& pos : positions_) {
+            margin += pos.margin;
+        }
+        return margin;
+    }
+
+    // Unrealized PnL of the open positions at the last bar's close, net of
+    // their entry fees and accrued funding. O(1): kept as running sums.
+    [[nodiscard]] double openPnl() const { return netQuantity_ * lastClose_ - netCost_ - openCharges_; }
+    [[nodiscard]] bool exposed() const { return !positions_.empty(); }
+
+    // A resting order and where it is indexed in the book.
+    struct RestingOrder {
+        OrderRequest order;
+        bool stopTriggered{false}; // stop-limit converted to its limit leg
+        double bookPrice{0.0};     // price it is currently indexed at
+    };
+
+    // Resting orders, sorted by OrderRequest::id.
+    [[nodiscard]] const std::vector<RestingOrder>& restingOrders() const { return orders_; }
+
+    // Trades closed and PnL realized by this engine (its share of a shared account).
+    [[nodiscard]] std::size_t tradeCount() const { return tradeCount_; }
+    [[nodiscard]] double realizedPnl() const { return realizedPnl_; }
+
+    // Replaces the cost model built from StrategyConfig::costs. Call before
+    // the run starts.
+    void setCostModel(std::shared_ptr<const CostModel> costs) {
+        if (!costs) {
+            throw std::invalid_argument("Cost model cannot be null.");
+        }
+        costs_ = std::move(costs);
+    }
+
+    // Keeps the per-bar equity curve on the account (see
+    // Account::recordEquityCurve), e.g. for results output.
+    void recordEquityCurve(std::size_t reserveBars = 0) { account_->recordEquityCurve(reserveBars); }
+
+    // Preallocates the trade log. With it sized for the run, the bar loop
+    // performs no heap allocations.
+    void reserveTrades(std::size_t count) { account_->reserveTrades(count); }
+
 private:
+    static constexpr std::size_t kSignalWindow = 4096;
+
+    void runBatch(const BarSeries& series) {
+        const std::size_t n = series.size();
+        std::vector<Signal> signals(std::min(n, kSignalWindow));
+
+        start(series.row(0));
+        for (std::size_t begin = 0; begin < n; begin += kSignalWindow) {
+            const std::size_t end = std::min(n, begin + kSignalWindow);
+            const std::span<Signal> window{signals.data(), end - begin};
+            std::fill(window.begin(), window.end(), Signal{});
+            strategy_->on_batch(series, begin, end, window);
+
+            // Same order as step(): stops first, then exits, then entries
+            // if the book had room before this bar's exits.
+            for (std::size_t i = begin; i < end; ++i) {
+                const Signal& signal = window[i - begin];
+                const Bar bar = series.row(i);
+                accrueFunding(bar);
+                if (!positions_.empty()) {
+                    matchIntrabar(bar);
+                }
+                const bool hasRoom = positions_.size() < maxOpenPositions_;
+                if (signal.flags & Signal::ExitLong) {
+                    closeSide(Side::Long, bar);
+                }
+                if (signal.flags & Signal::ExitShort) {
+                    closeSide(Side::Short, bar);
+                }
+                if (hasRoom && (signal.flags & (Signal::EnterLong | Signal::EnterShort))) {
+                    OrderRequest order;
+                    order.side = (signal.flags & Signal::EnterLong) ? Side::Long : Side::Short;
+                    order.sizeUsd = signal.sizeUsd;
+                    processOpenOrder(order, bar);
+                }
+                markBar(bar);
+            }
+        }
+        finish();
+    }
+
+    void finish() {
+        stop();
+        if (verbose_) {
+            account_->printSummary();
+        }
+    }
+
     void processOpenOrder(const OrderRequest& order, const Bar& currentBar) {
+        openPosition(order, currentBar.close, currentBar, Liquidity::Taker);
+    }
+
+    // Opens a position for order, quoted at price during bar. The cost model
+    // turns the quote into the executed price and the entry fee.
+    void openPosition(const OrderRequest& order, double price, const Bar& bar, Liquidity liquidity) {
+        if (order.leverage <= 0) {
+            throw std::invalid_argument("Order leverage must be positive.");
+        }
+        const double margin = order.sizeUsd / order.leverage;
+        if (margin > account_->availableMargin()) {
+            if (verbose_) {
+                LOG_DEBUG << "EXEC: Rejected " << (order.side == Side::Long ? "LONG" : "SHORT")
+                          << " order of " << order.sizeUsd << " USD: needs " << margin
+                          << " margin, " << account_->availableMargin() << " available";
+            }
+            return;
+        }
+
+        const double fillPrice =
+            costs_->fillPrice(order.side == Side::Long, price, order.sizeUsd / price, bar, liquidity);
+
         Position newPosition;
+        newPosition.id = nextPositionId_++;
         newPosition.side = order.side;
-        newPosition.entryPrice = currentBar.close;
-        newPosition.entryTimestamp = currentBar.timestamp;
-        newPosition.sizeAmount = order.sizeUsd / currentBar.close;
+        newPosition.entryPrice = fillPrice;
+        newPosition.entryTimestamp = bar.timestamp;
+        newPosition.sizeAmount = order.sizeUsd / fillPrice;
         newPosition.leverage = order.leverage;
+        newPosition.margin = margin;
+        // Both legs pay fees on executed notional (quantity * fill price).
+        newPosition.fee = costs_->fee(newPosition.sizeAmount * fillPrice, liquidity);
 
         if (order.stopLossPrice > 0) {
             newPosition.stopLossPrice = order.stopLossPrice;
@@ -65,14 +300,23 @@ private:
         }
         
         positions_.push_back(newPosition);
-        std::cout << "EXEC: Opened " << (order.side == Side::Long ? "LONG" : "SHORT") 
-                    << " position of " << newPosition.sizeAmount 
+        addLevels(newPosition);
+        const double sign = order.side == Side::Long ? 1.0 : -1.0;
+        netQuantity_ += sign * newPosition.sizeAmount;
+        netCost_ += sign * newPosition.sizeAmount * fillPrice;
+        openCharges_ += newPosition.fee;
+        account_->reserveMargin(margin);
+        if (!verbose_) return;
+        LOG_DEBUG << "EXEC: Opened " << (order.side == Side::Long ? "LONG" : "SHORT")
+                    << " position #" << newPosition.id << " of " << newPosition.sizeAmount 
                     << " @ " << newPosition.entryPrice 
                     << " SL: " << newPosition.stopLossPrice 
-                    << " TP: " << newPosition.takeProfitPrice << std::endl;
+                    << " TP: " << newPosition.takeProfitPrice;
     }
 
-    void closePosition(std::size_t index, double exitPrice, std::int64_t exitTimestamp) {
+    // Closes positions_[index] at the quoted price during bar. The recorded
+    // PnL is net of entry and exit fees and of the funding accrued while held.
+    void closePosition(std::size_t index, double price, const Bar& bar, Liquidity liquidity) {
         if (index >= positions_.size()) return;
 
         const auto& pos = positions_[index];
@@ -81,44 +325,326 @@ private:
         trade.sizeAmount = pos.sizeAmount;
         trade.entryPrice = pos.entryPrice;
         trade.entryTimestamp = pos.entryTimestamp;
-        trade.exitPrice = exitPrice;
-        trade.exitTimestamp = exitTimestamp;
-        
+        trade.exitPrice = costs_->fillPrice(pos.side == Side::Short, price, pos.sizeAmount, bar, liquidity);
+        trade.exitTimestamp = bar.timestamp;
+
         double pnl = (trade.exitPrice - trade.entryPrice) * trade.sizeAmount;
         if (trade.side == Side::Short) {
             pnl = -pnl;
         }
+        trade.fee = pos.fee + costs_->fee(trade.exitPrice * trade.sizeAmount, liquidity);
+        trade.funding = pos.funding;
+        pnl -= trade.fee + trade.funding;
         trade.pnl = pnl;
 
-        account_.recordTrade(trade);
-        positions_.erase(positions_.begin() + index);
+        removeLevels(pos);
+        account_->releaseMargin(pos.margin);
+        account_->recordTrade(trade);
+        const double sign = pos.side == Side::Long ? 1.0 : -1.0;
+        netQuantity_ -= sign * pos.sizeAmount;
+        netCost_ -= sign * pos.sizeAmount * pos.entryPrice;
+        openCharges_ -= pos.fee + pos.funding;
+        positions_.erase(positions_.begin() + static_cast<std::ptrdiff_t>(index));
+        if (positions_.empty()) {
+            // Drop the rounding residue of the running sums.
+            netQuantity_ = netCost_ = openCharges_ = 0.0;
+        }
+        ++tradeCount_;
+        realizedPnl_ += pnl;
+
+        if (!verbose_) return;
+        LOG_DEBUG << "EXEC: Closed " << (trade.side == Side::Long ? "LONG" : "SHORT")
+                  << " position @ " << trade.exitPrice << " for a PNL of " << pnl;
+    }
+
+    // ---- Resting orders -------------------------------------------------
+
+    enum class BookKind { LongStop, ShortStop, LongTarget, ShortTarget, BuyEntry, SellEntry };
+
+    struct BookRef {
+        LevelBook* book;
+        BookKind kind;
+    };
 
-        std::cout << "EXEC: Closed " << (trade.side == Side::Long ? "LONG" : "SHORT") 
-                  << " position @ " << exitPrice << " for a PNL of " << pnl << std::endl;
+    // The book an order rests in: untriggered stops by stop price, limits by limit price.
+    LevelBook& entryBook(const RestingOrder& resting) {
+        const bool isLong = resting.order.side == Side::Long;
+        const bool byStop = resting.order.type == OrderType::Stop ||
+                            (resting.order.type == OrderType::StopLimit && !resting.stopTriggered);
+        if (byStop) {
+            return isLong ? buyStops_ : sellStops_;
+        }
+        return isLong ? buyLimits_ : sellLimits_;
     }
 
+    void submitOrder(OrderRequest order) {
+        if (order.type == OrderType::Market) {
+            throw std::invalid_argument("Market orders cannot rest in the order book.");
+        }
+        const bool needsLimit = order.type == OrderType::Limit || order.type == OrderType::StopLimit;
+        const bool needsStop = order.type == OrderType::Stop || order.type == OrderType::StopLimit;
+        if ((needsLimit && order.limitPrice <= 0) || (needsStop && order.stopPrice <= 0)) {
+            throw std::invalid_argument("Resting order is missing its limit or stop price.");
+        }
+        if (order.id == 0) {
+            order.id = nextOrderId_++;
+        }
+
+        RestingOrder resting{order, false, needsStop ? order.stopPrice : order.limitPrice};
+        auto it = findOrder(order.id);
+        if (it != orders_.end() && it->order.id == order.id) {
+            throw std::invalid_argument("Duplicate resting order id " + std::to_string(order.id) + ".");
+        }
+        entryBook(resting).insert(resting.bookPrice, order.id);
+        orders_.insert(it, resting);
+        if (order.expiryTimestamp > 0) {
+            expiries_.emplace_back(order.expiryTimestamp, order.id);
+            std::push_heap(expiries_.begin(), expiries_.end(), std::greater<>{});
+        }
+    }
+
+    std::vector<RestingOrder>::iterator findOrder(std::uint64_t id) {
+        return std::lower_bound(orders_.begin(), orders_.end(), id,
+                                [](const RestingOrder& o, std::uint64_t key) { return o.order.id < key; });
+    }
+
+    bool cancelOrder(std::uint64_t id) {
+        auto it = findOrder(id);
+        if (it == orders_.end() || it->order.id != id) return false;
+        entryBook(*it).erase(it->bookPrice, id);
+        orders_.erase(it);
+        return true;
+    }
+
+    // Drops orders whose expiry is before this bar. Entries for orders that
+    // already left the book are skipped.
+    void expireOrders(std::int64_t timestamp) {
+        while (!expiries_.empty() && expiries_.front().first < timestamp) {
+            const auto id = expiries_.front().second;
+            std::pop_heap(expiries_.begin(), expiries_.end(), std::greater<>{});
+            expiries_.pop_back();
+            auto it = findOrder(id);
+            if (it != orders_.end() && it->order.id == id && it->order.expiryTimestamp < timestamp) {
+                cancelOrder(id);
+            }
+        }
+    }
+
+    // Resolves stops, targets and resting orders inside one bar.
+    void matchIntrabar(const Bar& bar) {
+        if (intrabarPath_ == IntrabarPath::StopFirst) {
+            checkSLTP(bar);
+            if (!orders_.empty()) {
+                walkPath(bar, IntrabarPath::Auto, false);
+            }
+        } else if (!positions_.empty() || !orders_.empty()) {
+            walkPath(bar, intrabarPath_, true);
+        }
+    }
+
+    // Walks the bar's price path (open, then both extremes in path order, then
+    // close), firing crossed levels in the order the path reaches them. Each
+    // step only inspects the next level of each book, so matching costs
+    // O(fills) per bar; inserting or removing a level costs a binary search
+    // plus an O(n) shift (see LevelBook). A level the path has
+    // already passed (a gap at the open) fills at the current price.
+    void walkPath(const Bar& bar, IntrabarPath path, bool withPositions) {
+        if (path == IntrabarPath::Auto) {
+            path = bar.close >= bar.open ? IntrabarPath::OpenLowHighClose : IntrabarPath::OpenHighLowClose;
+        }
+        const double points[4] = {bar.open,
+                                  path == IntrabarPath::OpenHighLowClose ? bar.high : bar.low,
+                                  path == IntrabarPath::OpenHighLowClose ? bar.low : bar.high,
+                                  bar.close};
+
+        // Ties at one price go to position stops, then targets, then entries.
+        const BookRef rising[] = {{&shortStops_, BookKind::ShortStop}, {&longTargets_, BookKind::LongTarget},
+                                  {&buyStops_, BookKind::BuyEntry}, {&sellLimits_, BookKind::SellEntry}};
+        const BookRef falling[] = {{&longStops_, BookKind::LongStop}, {&shortTargets_, BookKind::ShortTarget},
+                                   {&sellStops_, BookKind::SellEntry}, {&buyLimits_, BookKind::BuyEntry}};
+        const std::size_t first = withPositions ? 0 : 2;
+
+        double cursor = bar.open;
+        sweep(rising, first, true, bar.open, cursor, bar);
+        sweep(falling, first, false, bar.open, cursor, bar);
+        for (int k = 1; k < 4; ++k) {
+            if (points[k] > points[k - 1]) {
+                sweep(rising, first, true, points[k], cursor, bar);
+            } else if (points[k] < points[k - 1]) {
+                sweep(falling, first, false, points[k], cursor, bar);
+            }
+        }
+    }
+
+    // Fires every level up to (rising) or down to (falling) target, nearest first.
+    void sweep(const BookRef (&books)[4], std::size_t first, bool up, double target, double& cursor,
+               const Bar& bar) {
+        while (true) {
+            const BookRef* best = nullptr;
+            for (std::size_t b = first; b < 4; ++b) {
+                if (books[b].book->empty()) continue;
+                const double price = books[b].book->next().price;
+                if (up ? price > target : price < target) continue;
+                if (!best || (up ? price < best->book->next().price : price > best->book->next().price)) {
+                    best = &books[b];
+                }
+            }
+            if (!best) return;
+
+            const auto level = best->book->pop();
+            cursor = up ? std::max(cursor, level.price) : std::min(cursor, level.price);
+            if (best->kind == BookKind::BuyEntry || best->kind == BookKind::SellEntry) {
+                fillOrder(level.id, cursor, bar);
+            } else {
+                const bool stop = best->kind == BookKind::LongStop || best->kind == BookKind::ShortStop;
+                closeById(level.id, cursor, bar, stop ? Liquidity::Taker : Liquidity::Maker);
+            }
+        }
+    }
+
+    // A resting order's level was reached at price.
+    // Limit orders, including a stop-limit's resting limit leg, fill as maker;
+    // stops and a stop-limit that is marketable when triggered fill as taker.
+    void fillOrder(std::uint64_t id, double price, const Bar& bar) {
+        auto it = findOrder(id);
+        if (it == orders_.end() || it->order.id != id) return;
+
+        const Liquidity liquidity = it->order.type == OrderType::Limit ||
+                                            (it->order.type == OrderType::StopLimit && it->stopTriggered)
+                                        ? Liquidity::Maker
+                                        : Liquidity::Taker;
+        if (it->order.type == OrderType::StopLimit && !it->stopTriggered) {
+            // Stop reached: the limit leg fills now if marketable, else rests.
+            it->stopTriggered = true;
+            const double limit = it->order.limitPrice;
+            const bool marketable = it->order.side == Side::Long ? price <= limit : price >= limit;
+            if (!marketable) {
+                it->bookPrice = limit;
+                entryBook(*it).insert(limit, id);
+                return;
+            }
+        }
+
+        const OrderRequest order = it->order;
+        orders_.erase(it);
+        if (positions_.size() >= maxOpenPositions_) {
+            if (verbose_) {
+                LOG_DEBUG << "EXEC: Dropped resting order #" << id << ": maxOpenPositions reached";
+            }
+            return;
+        }
+        openPosition(order, price, bar, liquidity);
+    }
+
+    // Closes every position whose stop-loss or take-profit lies inside the
+    // bar's range. Only crossed levels are touched. Stops are processed before
+    // targets, so a position with both inside the bar is stopped out. Stops
+    // fill as taker, targets as maker.
     void checkSLTP(const Bar& currentBar) {
         if (positions_.empty()) return;
 
-        const auto& pos = positions_[0];
-        if (pos.side == Side::Long) {
-            if (pos.stopLossPrice > 0 && currentBar.low <= pos.stopLossPrice) {
-                closePosition(0, pos.stopLossPrice, currentBar.timestamp);
-            } else if (pos.takeProfitPrice > 0 && currentBar.high >= pos.takeProfitPrice) {
-                closePosition(0, pos.takeProfitPrice, currentBar.timestamp);
+        for (LevelBook* book : {&longStops_, &shortStops_, &longTargets_, &shortTargets_}) {
+            const bool stop = book == &longStops_ || book == &shortStops_;
+            while (book->triggered(currentBar.low, currentBar.high)) {
+                const auto level = book->pop();
+                closeById(level.id, level.price, currentBar, stop ? Liquidity::Taker : Liquidity::Maker);
             }
-        } else { // Short position
-            if (pos.stopLossPrice > 0 && currentBar.high >= pos.stopLossPrice) {
-                closePosition(0, pos.stopLossPrice, currentBar.timestamp);
-            } else if (pos.takeProfitPrice > 0 && currentBar.low <= pos.takeProfitPrice) {
-                closePosition(0, pos.takeProfitPrice, currentBar.timestamp);
+        }
+    }
+
+    // Charges each open position the funding for the time since the previous
+    // bar, on its notional at this bar's open.
+    void accrueFunding(const Bar& bar) {
+        for (auto& pos : positions_) {
+            const double paid = costs_->funding(pos.side, pos.sizeAmount * bar.open, lastTimestamp_, bar.timestamp);
+            pos.funding += paid;
+            openCharges_ += paid;
+        }
+        lastTimestamp_ = bar.timestamp;
+    }
+
+    // End of a bar: records the close and, for an engine owning its account,
+    // marks the equity curve.
+    void markBar(const Bar& bar) {
+        lastClose_ = bar.close;
+        if (marksAccount_) {
+            account_->markToMarket(bar.timestamp, openPnl(), exposed());
+        }
+    }
+
+    void addLevels(const Position& pos) {
+        if (pos.stopLossPrice > 0) {
+            (pos.side == Side::Long ? longStops_ : shortStops_).insert(pos.stopLossPrice, pos.id);
+        }
+        if (pos.takeProfitPrice > 0) {
+            (pos.side == Side::Long ? longTargets_ : shortTargets_).insert(pos.takeProfitPrice, pos.id);
+        }
+    }
+
+    // Levels already popped by checkSLTP are simply not found.
+    void removeLevels(const Position& pos) {
+        if (pos.stopLossPrice > 0) {
+            (pos.side == Side::Long ? longStops_ : shortStops_).erase(pos.stopLossPrice, pos.id);
+        }
+        if (pos.takeProfitPrice > 0) {
+            (pos.side == Side::Long ? longTargets_ : shortTargets_).erase(pos.takeProfitPrice, pos.id);
+        }
+    }
+
+    // positions_ stays sorted by id (appended in id order, erased in place).
+    void closeById(std::uint64_t id, double exitPrice, const Bar& bar, Liquidity liquidity) {
+        auto it = std::lower_bound(positions_.begin(), positions_.end(), id,
+                                   [](const Position& pos, std::uint64_t key) { return pos.id < key; });
+        if (it != positions_.end() && it->id == id) {
+            closePosition(static_cast<std::size_t>(it - positions_.begin()), exitPrice, bar, liquidity);
+        }
+    }
+
+    // Strategy exits fill at the bar close as taker.
+    void closeSide(Side side, const Bar& bar) {
+        for (std::size_t i = positions_.size(); i-- > 0;) {
+            if (positions_[i].side == side) {
+                closePosition(i, bar.close, bar, Liquidity::Taker);
             }
         }
     }
 
+    void closeAll(const Bar& bar) {
+        while (!positions_.empty()) {
+            closePosition(positions_.size() - 1, bar.close, bar, Liquidity::Taker);
+        }
+    }
+
     std::shared_ptr<IStrategy> strategy_;
-    Account account_;
-    ThreadPool threadPool_;
+    std::shared_ptr<Account> account_;
+    bool verbose_;
+    std::size_t maxOpenPositions_;
+    IntrabarPath intrabarPath_;
+    std::shared_ptr<const CostModel> costs_;
+    std::int64_t lastTimestamp_{0}; // previous bar, start of the next funding interval
+    bool marksAccount_{false};
+    double lastClose_{0.0};
+    // Running sums over positions_ for O(1) marking: signed quantity, signed
+    // entry notional, and entry fees plus funding accrued.
+    double netQuantity_{0.0};
+    double netCost_{0.0};
+    double openCharges_{0.0};
+    std::size_t tradeCount_{0};
+    double realizedPnl_{0.0};
 
     std::vector<Position> positions_{};
+    std::uint64_t nextPositionId_{1};
+    LevelBook longStops_{LevelTrigger::AtOrBelow};
+    LevelBook shortStops_{LevelTrigger::AtOrAbove};
+    LevelBook longTargets_{LevelTrigger::AtOrAbove};
+    LevelBook shortTargets_{LevelTrigger::AtOrBelow};
+
+    // Resting entry orders, indexed by trigger price.
+    std::vector<RestingOrder> orders_;
+    std::uint64_t nextOrderId_{1ULL << 62}; // engine-assigned ids, clear of strategy-chosen ones
+    std::vector<std::pair<std::int64_t, std::uint64_t>> expiries_; // min-heap of (expiry, order id)
+    LevelBook buyLimits_{LevelTrigger::AtOrBelow};
+    LevelBook sellLimits_{LevelTrigger::AtOrAbove};
+    LevelBook buyStops_{LevelTrigger::AtOrAbove};
+    LevelBook sellStops_{LevelTrigger::AtOrBelow};
 }; 
\ No newline at end of file
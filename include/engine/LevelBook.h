@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Which side of a price level a bar has to trade through for it to fire.
+enum class LevelTrigger {
+    AtOrBelow, // fires when bar.low <= price (long stop-loss, short take-profit)
+    AtOrAbove, // fires when bar.high >= price (long take-profit, short stop-loss)
+};
+
+// Price-sorted book of trigger levels (stop-loss/take-profit prices or resting
+// order prices), each tagged with the id of the position or order it belongs to.
+//
+// Levels are kept in a flat vector ordered so that the level that fires first
+// sits at the back: for AtOrBelow the highest price, for AtOrAbove the lowest.
+// A bar therefore only touches the levels its [low, high] range crossed,
+// popping them off the back, instead of scanning every open position. Among
+// equal prices, the smaller (older) id fires first.
+//
+// insert() and erase() binary-search the position (O(log n)) but shift the
+// tail of the vector, so they are O(n) moves of 16-byte levels; pop() is O(1).
+// For the few dozen levels a strategy keeps, the shift is one short memmove
+// and beats a node-based tree.
+class LevelBook {
+public:
+    struct Level {
+        double price;
+        std::uint64_t id;
+    };
+
+    explicit LevelBook(LevelTrigger trigger) : trigger_{trigger} {}
+
+    void reserve(std::size_t count) { levels_.reserve(count); }
+
+    void insert(double price, std::uint64_t id) {
+        const Level level{price, id};
+        levels_.insert(std::upper_bound(levels_.begin(), levels_.end(), level, order()), level);
+    }
+
+    // Removes the level of a position or order that left by other means.
+    // Returns false if absent.
+    bool erase(double price, std::uint64_t id) {
+        const Level level{price, id};
+        auto it = std::lower_bound(levels_.begin(), levels_.end(), level, order());
+        if (it == levels_.end() || it->id != id || it->price != price) {
+            return false;
+        }
+        levels_.erase(it);
+        return true;
+    }
+
+    // True if the back level fires within [low, high].
+    [[nodiscard]] bool triggered(double low, double high) const {
+        if (levels_.empty()) return false;
+        const double price = levels_.back().price;
+        return trigger_ == LevelTrigger::AtOrBelow ? low <= price : high >= price;
+    }
+
+    // The level that fires first. Call only when !empty().
+    [[nodiscard]] const Level& next() const { return levels_.back(); }
+
+    // Removes and returns the level that fires first. Call only when !empty().
+    Level pop() {
+        const Level level = levels_.back();
+        levels_.pop_back();
+        return level;
+    }
+
+    [[nodiscard]] std::size_t size() const { return levels_.size(); }
+    [[nodiscard]] bool empty() const { return levels_.empty(); }
+
+private:
+    // Strict weak order placing the first level to fire last.
+    struct FiresLater {
+        LevelTrigger trigger;
+        bool operator()(const Level& a, const Level& b) const {
+            if (a.price != b.price) {
+                return trigger == LevelTrigger::AtOrBelow ? a.price < b.price : a.price > b.price;
+            }
+            return a.id > b.id;
+        }
+    };
+
+    [[nodiscard]] FiresLater order() const { return FiresLater{trigger_}; }
+
+    LevelTrigger trigger_;
+    std::vector<Level> levels_;
+};
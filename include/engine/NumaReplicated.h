@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "core/Topology.h"
+
+// Read-only data with one copy per NUMA node.
+//
+// Each copy is made on a thread pinned to a CPU of its node, so the kernel's
+// first-touch policy backs it with that node's memory; pinned pool workers
+// then read local() and never cross the socket interconnect for bars. With
+// replication off, or on a single-node machine, every node shares `value`
+// itself and nothing is copied.
+template <typename T>
+class NumaReplicated {
+public:
+    // Without replication `value` is borrowed and must outlive this object.
+    NumaReplicated(const T& value, bool replicate, const topology::Topology& topo = topology::Topology::system()) {
+        if (!replicate || topo.nodeCount() < 2) {
+            copies_.emplace_back(std::shared_ptr<const T>{}, &value);
+            return;
+        }
+
+        copies_.resize(topo.nodeCount());
+        std::vector<std::exception_ptr> errors(topo.nodeCount());
+        std::vector<std::thread> copiers;
+        copiers.reserve(topo.nodeCount());
+        for (std::size_t n = 0; n < topo.nodeCount(); ++n) {
+            copiers.emplace_back([this, &value, &topo, &errors, n] {
+                topology::pinCurrentThread({topo.nodes()[n].cpus.front(), n});
+                try {
+                    copies_[n] = std::make_shared<const T>(value);
+                } catch (...) {
+                    errors[n] = std::current_exception();
+                }
+            });
+        }
+        for (auto& copier : copiers) copier.join();
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    // The copy for the calling thread's node (see topology::currentNode).
+    [[nodiscard]] const T& local() const { return forNode(topology::currentNode()); }
+
+    [[nodiscard]] const T& forNode(std::size_t node) const {
+        return *copies_[node < copies_.size() ? node : 0];
+    }
+
+    [[nodiscard]] std::size_t copies() const { return copies_.size(); }
+
+private:
+    std::vector<std::shared_ptr<const T>> copies_;
+};
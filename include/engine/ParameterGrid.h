@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "strategy/StrategyConfig.h"
+
+// Cartesian product of parameter values for a sweep.
+//
+// Axis names matching a StrategyConfig field (stopLossPercent, takeProfitPercent,
+// perTradeSize, initialCapital, maxOpenPositions) override that field; any other
+// name is written to StrategyConfig::params (e.g. "smaPeriod").
+class ParameterGrid {
+public:
+    struct Axis {
+        std::string name;
+        std::vector<double> values;
+    };
+
+    void addAxis(std::string name, std::vector<double> values) {
+        if (values.empty()) {
+            throw std::invalid_argument("Parameter axis has no values: " + name);
+        }
+        if (name == "maxOpenPositions") {
+            for (const double value : values) {
+                StrategyConfig::positionCount(value); // reject bad values before any run starts
+            }
+        }
+        axes_.push_back({std::move(name), std::move(values)});
+    }
+
+    // Parses a JSON object of the form {"stopLossPercent": [1.0, 2.0], "smaPeriod": [10, 20]}.
+    static ParameterGrid fromJsonFile(const std::string& path) {
+        std::ifstream f(path);
+        if (!f.is_open()) {
+            throw std::runtime_error("Could not open parameter grid file: " + path);
+        }
+        const nlohmann::json data = nlohmann::json::parse(f);
+        if (!data.is_object()) {
+            throw std::runtime_error("Parameter grid must be a JSON object: " + path);
+        }
+
+        ParameterGrid grid;
+        for (const auto& [name, values] : data.items()) {
+            grid.addAxis(name, values.get<std::vector<double>>());
+        }
+        return grid;
+    }
+
+    [[nodiscard]] const std::vector<Axis>& axes() const { return axes_; }
+
+    // Number of parameter combinations.
+    [[nodiscard]] std::size_t size() const {
+        std::size_t n = 1;
+        for (const auto& axis : axes_) {
+            n *= axis.values.size();
+        }
+        return n;
+    }
+
+    // Returns the base config with combination #index applied. The last axis
+    // varies fastest.
+    [[nodiscard]] StrategyConfig configAt(std::size_t index, const StrategyConfig& base) const {
+        StrategyConfig config = base;
+        for (auto it = axes_.rbegin(); it != axes_.rend(); ++it) {
+            const std::size_t n = it->values.size();
+            apply(config, it->name, it->values[index % n]);
+            index /= n;
+        }
+        return config;
+    }
+
+    static void apply(StrategyConfig& config, const std::string& name, double value) {
+        if (name == "initialCapital") {
+            config.initialCapital = value;
+        } else if (name == "stopLossPercent") {
+            config.stopLossPercent = value;
+        } else if (name == "takeProfitPercent") {
+            config.takeProfitPercent = value;
+        } else if (name == "perTradeSize") {
+            config.perTradeSize = value;
+        } else if (name == "maxOpenPositions") {
+            config.maxOpenPositions = StrategyConfig::positionCount(value);
+        } else {
+            config.params[name] = value;
+        }
+    }
+
+private:
+    std::vector<Axis> axes_;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/Account.h"
+#include "core/BarSeries.h"
+#include "core/Log.h"
+#include "engine/ExecutionEngine.h"
+
+// Backtests several symbols together against one shared Account.
+//
+// Each symbol keeps its own strategy, ExecutionEngine (positions, SL/TP) and
+// time-sorted BarSeries. run() walks all series in global timestamp order with
+// a k-way merge: a min-heap holds one cursor per symbol, so the extra state is
+// O(symbols) and the run is O(total bars * log symbols). Bars sharing a
+// timestamp are dispatched in the order the symbols were added, and the shared
+// account is marked to market once per timestamp after all of them.
+class PortfolioEngine {
+public:
+    explicit PortfolioEngine(double initialCapital, bool verbose = true)
+        : account_{std::make_shared<Account>(initialCapital)}, verbose_{verbose} {}
+
+    // Adds one symbol. bars must be sorted by timestamp.
+    void addSymbol(std::string symbol, std::shared_ptr<IStrategy> strategy, BarSeries bars) {
+        const auto timestamps = bars.timestamps();
+        for (std::size_t i = 1; i < timestamps.size(); ++i) {
+            if (timestamps[i] < timestamps[i - 1]) {
+                throw std::invalid_argument("Bars for " + symbol + " are not sorted by timestamp.");
+            }
+        }
+        legs_.push_back(Leg{std::move(symbol), std::move(bars),
+                            std::make_unique<ExecutionEngine>(std::move(strategy), account_, verbose_)});
+    }
+
+    void run() {
+        struct Cursor {
+            std::int64_t timestamp;
+            std::size_t leg;
+            std::size_t index;
+        };
+        // Min-heap on (timestamp, leg); std::priority_queue is a max-heap.
+        auto later = [](const Cursor& a, const Cursor& b) {
+            return a.timestamp != b.timestamp ? a.timestamp > b.timestamp : a.leg > b.leg;
+        };
+        std::vector<Cursor> storage;
+        storage.reserve(legs_.size());
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap{later, std::move(storage)};
+
+        for (std::size_t leg = 0; leg < legs_.size(); ++leg) {
+            const BarSeries& bars = legs_[leg].bars;
+            if (bars.empty()) continue;
+            legs_[leg].engine->start(bars.row(0));
+            heap.push({bars.timestamps()[0], leg, 0});
+        }
+
+        while (!heap.empty()) {
+            const Cursor cursor = heap.top();
+            heap.pop();
+
+            Leg& leg = legs_[cursor.leg];
+            leg.engine->step(leg.bars.row(cursor.index));
+
+            const std::size_t next = cursor.index + 1;
+            if (next < leg.bars.size()) {
+                heap.push({leg.bars.timestamps()[next], cursor.leg, next});
+            }
+            // Once every symbol has seen this timestamp, mark the shared
+            // account with all legs' open PnL at their latest closes.
+            if (heap.empty() || heap.top().timestamp != cursor.timestamp) {
+                markToMarket(cursor.timestamp);
+            }
+        }
+
+        for (auto& leg : legs_) {
+            if (!leg.bars.empty()) {
+                leg.engine->stop();
+            }
+        }
+        if (verbose_) {
+            printSummary();
+        }
+    }
+
+    [[nodiscard]] const Account& account() const { return *account_; }
+
+    // Keeps the shared account's per-timestamp equity curve.
+    void recordEquityCurve(std::size_t reserveBars = 0) { account_->recordEquityCurve(reserveBars); }
+
+    [[nodiscard]] std::size_t symbolCount() const { return legs_.size(); }
+    [[nodiscard]] const std::string& symbol(std::size_t leg) const { return legs_.at(leg).symbol; }
+
+    // Per-symbol view of the shared account: open positions, margin held, and
+    // realized results.
+    [[nodiscard]] const ExecutionEngine& engine(std::size_t leg) const { return *legs_.at(leg).engine; }
+
+    void printSummary() const {
+        logging::flush(); // earlier log lines first
+        std::cout << "\n--- Portfolio Breakdown (" << legs_.size() << " symbols) ---\n";
+        std::cout << std::left << std::setw(20) << "Symbol" << std::setw(8) << "Trades"
+                  << std::setw(14) << "Net PNL" << "Margin Used\n";
+        std::cout << std::fixed << std::setprecision(2);
+        for (const auto& leg : legs_) {
+            std::cout << std::left << std::setw(20) << leg.symbol << std::setw(8) << leg.engine->tradeCount()
+                      << std::setw(14) << leg.engine->realizedPnl() << leg.engine->usedMargin() << "\n";
+        }
+        account_->printSummary();
+    }
+
+private:
+    void markToMarket(std::int64_t timestamp) {
+        double openPnl = 0.0;
+        bool exposed = false;
+        for (const auto& leg : legs_) {
+            openPnl += leg.engine->openPnl();
+            exposed = exposed || leg.engine->exposed();
+        }
+        account_->markToMarket(timestamp, openPnl, exposed);
+    }
+
+    struct Leg {
+        std::string symbol;
+        BarSeries bars;
+        std::unique_ptr<ExecutionEngine> engine;
+    };
+
+    std::shared_ptr<Account> account_;
+    bool verbose_;
+    std::vector<Leg> legs_;
+};
@@ -1,61 +1,303 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
-#include <vector>
-#include <functional>
 #include <type_traits>
+#include <utility>
+#include <vector>
+#include "core/Topology.h"
+#include "engine/Task.h"
+#include "engine/WorkStealingDeque.h"
+
+// Work-stealing thread pool.
+//
+// Each worker owns a Chase-Lev deque: tasks submitted from a worker (nested
+// work) go to its own deque without a lock, and idle workers steal from the
+// others. Tasks submitted from outside the pool go to a shared injection
+// queue, taken in bulk under one short lock. Tasks are move-only Task objects
+// with an inline buffer, so a small lambda costs one node allocation and no
+// std::function or shared_ptr.
+//
+//  - enqueue(f, args...) returns a std::future, as before;
+//  - submit(f) is fire-and-forget (f must not throw);
+//  - parallel_for(begin, end, body) runs body(i) for every index with dynamic
+//    chunking and no per-index task or future, on the pool's workers only.
+struct PoolOptions {
+    std::size_t threads{std::thread::hardware_concurrency()};
+    // Pin worker i to topology::Topology::system().place(i): one CPU each,
+    // spread evenly over the NUMA nodes. Workers then report their node
+    // through topology::currentNode().
+    bool pinThreads{false};
+};
 
 class ThreadPool {
 public:
-    explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency()) {
-        start(threadCount);
+    explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency())
+        : ThreadPool(PoolOptions{threadCount}) {}
+
+    explicit ThreadPool(const PoolOptions& options) {
+        start(std::max<std::size_t>(1, options.threads), options.pinThreads);
     }
 
     ~ThreadPool() {
         stop();
     }
 
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] std::size_t size() const { return workers_.size(); }
+
     // Enqueue a task returning a future
     template <typename F, typename... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
         using ReturnT = std::invoke_result_t<F, Args...>;
-        auto taskPtr = std::make_shared<std::packaged_task<ReturnT()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        std::packaged_task<ReturnT()> task{
+            [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable {
+                return std::invoke(std::move(f), std::move(args)...);
+            }};
+        std::future<ReturnT> result = task.get_future();
+        push(new Task{std::move(task)});
+        return result;
+    }
 
-        std::future<ReturnT> result = taskPtr->get_future();
-        {
-            std::unique_lock lock{mutex_};
-            tasks_.emplace([taskPtr]() { (*taskPtr)(); });
+    // Runs f() on the pool without a future. f must not throw.
+    template <typename F>
+    void submit(F&& f) {
+        push(new Task{std::forward<F>(f)});
+    }
+
+    // Calls body(i) for every i in [begin, end) and returns when all calls
+    // have finished, rethrowing the first exception thrown by body.
+    //
+    // Indices are claimed in chunks of `grain` from a shared atomic cursor by
+    // helper tasks submitted in one bulk hand-off. Fast workers simply claim
+    // more chunks, so uneven per-index cost balances itself. At most size()
+    // bodies run at once, all on pool workers (pinned ones, with
+    // PoolOptions::pinThreads): a caller outside the pool only sleeps until
+    // the helpers finish. A worker calling it (nested use) takes part as one
+    // of the size() and runs queued tasks while waiting, so it cannot deadlock.
+    template <typename F>
+    void parallel_for(std::size_t begin, std::size_t end, F&& body, std::size_t grain = 0) {
+        if (begin >= end) return;
+        const std::size_t count = end - begin;
+        if (grain == 0) {
+            grain = std::max<std::size_t>(1, count / (workers_.size() * 8));
+        }
+
+        struct Shared {
+            Shared(std::size_t first, std::size_t helpers) : next{first}, helpersLeft{helpers} {}
+
+            std::atomic<std::size_t> next;
+            std::atomic<std::size_t> helpersLeft; // decremented under `mutex`
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        const bool inside = context().pool == this;
+        const std::size_t chunks = (count + grain - 1) / grain;
+        const std::size_t helpers = inside ? std::min(workers_.size() - 1, chunks - 1)
+                                           : std::min(workers_.size(), chunks);
+        Shared shared{begin, helpers};
+
+        auto work = [&shared, &body, end, grain] {
+            while (!shared.failed.load(std::memory_order_relaxed)) {
+                const std::size_t from = shared.next.fetch_add(grain, std::memory_order_relaxed);
+                if (from >= end) return;
+                const std::size_t to = std::min(end, from + grain);
+                try {
+                    for (std::size_t i = from; i < to; ++i) {
+                        body(i);
+                    }
+                } catch (...) {
+                    if (!shared.failed.exchange(true)) {
+                        shared.error = std::current_exception();
+                    }
+                    return;
+                }
+            }
+        };
+
+        std::vector<Task*> tasks;
+        tasks.reserve(helpers);
+        for (std::size_t h = 0; h < helpers; ++h) {
+            tasks.push_back(new Task{[&shared, work] {
+                work();
+                // The caller may destroy `shared` as soon as this lock is released.
+                std::lock_guard lock{shared.mutex};
+                if (shared.helpersLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    shared.finished.notify_all();
+                }
+            }});
+        }
+        pushBulk(tasks);
+
+        // Helpers reference `shared` and `body`; wait for every one of them.
+        if (inside) {
+            work();
+            // Run queued tasks meanwhile (they may be our own helpers).
+            while (shared.helpersLeft.load(std::memory_order_acquire) > 0) {
+                if (!runOne()) {
+                    std::this_thread::yield();
+                }
+            }
+            std::lock_guard lock{shared.mutex}; // until the last helper lets go
+        } else {
+            std::unique_lock lock{shared.mutex};
+            shared.finished.wait(lock, [&shared] { return shared.helpersLeft.load() == 0; });
+        }
+        if (shared.error) {
+            std::rethrow_exception(shared.error);
         }
-        cv_.notify_one();
-        return result;
     }
 
 private:
+    struct Worker {
+        explicit Worker(std::uint64_t seed) : rng{seed} {}
+
+        WorkStealingDeque<Task*> deque;
+        std::uint64_t rng; // victim selection
+    };
+
+    // The pool and worker index of the calling thread, if it is a worker.
+    struct Context {
+        ThreadPool* pool{nullptr};
+        std::size_t index{0};
+    };
+    static Context& context() {
+        thread_local Context ctx;
+        return ctx;
+    }
+
+    std::vector<std::unique_ptr<Worker>> queues_;
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
 
-    std::mutex mutex_;
-    std::condition_variable cv_;
+    std::mutex injectMutex_;
+    std::deque<Task*> injected_;
+
+    // Sleep/wake: queued_ counts tasks pushed but not yet taken, sleepers_
+    // workers blocked (or about to block) on wake_. A submitter increments
+    // queued_ before reading sleepers_; a worker increments sleepers_ before
+    // re-reading queued_ under the lock, so one of them always sees the other.
+    std::atomic<std::size_t> queued_{0};
+    std::atomic<std::size_t> sleepers_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
     bool stop_{false};
 
-    void start(std::size_t n) {
+    void push(Task* task) {
+        Context& ctx = context();
+        if (ctx.pool == this) {
+            queues_[ctx.index]->deque.push(task);
+        } else {
+            std::lock_guard lock{injectMutex_};
+            injected_.push_back(task);
+        }
+        notify(1);
+    }
+
+    void pushBulk(const std::vector<Task*>& tasks) {
+        if (tasks.empty()) return;
+        Context& ctx = context();
+        if (ctx.pool == this) {
+            for (Task* task : tasks) {
+                queues_[ctx.index]->deque.push(task);
+            }
+        } else {
+            std::lock_guard lock{injectMutex_};
+            injected_.insert(injected_.end(), tasks.begin(), tasks.end());
+        }
+        notify(tasks.size());
+    }
+
+    void notify(std::size_t count) {
+        queued_.fetch_add(count);
+        if (sleepers_.load() > 0) {
+            std::lock_guard lock{sleepMutex_};
+            if (count == 1) {
+                wake_.notify_one();
+            } else {
+                wake_.notify_all();
+            }
+        }
+    }
+
+    // Own deque first (newest, cache-warm), then the injection queue, then
+    // the other workers' deques starting from a random victim.
+    Task* take() {
+        Context& ctx = context();
+        Task* task = nullptr;
+        const bool isWorker = ctx.pool == this;
+        if (isWorker && queues_[ctx.index]->deque.pop(task)) {
+            return task;
+        }
+        {
+            std::lock_guard lock{injectMutex_};
+            if (!injected_.empty()) {
+                task = injected_.front();
+                injected_.pop_front();
+                return task;
+            }
+        }
+        const std::size_t n = queues_.size();
+        std::size_t victim = isWorker ? static_cast<std::size_t>(nextRandom(queues_[ctx.index]->rng) % n) : 0;
+        for (std::size_t k = 0; k < n; ++k, victim = (victim + 1) % n) {
+            if (isWorker && victim == ctx.index) continue;
+            if (queues_[victim]->deque.steal(task)) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    // Runs one queued task if there is one.
+    bool runOne() {
+        if (queued_.load(std::memory_order_relaxed) == 0) return false;
+        Task* task = take();
+        if (!task) return false;
+        queued_.fetch_sub(1);
+        std::unique_ptr<Task> owned{task};
+        (*owned)();
+        return true;
+    }
+
+    static std::uint64_t nextRandom(std::uint64_t& state) {
+        // xorshift64
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    void start(std::size_t n, bool pin) {
+        for (std::size_t i = 0; i < n; ++i) {
+            queues_.push_back(std::make_unique<Worker>(0x9e3779b97f4a7c15ULL * (i + 1)));
+        }
         for (std::size_t i = 0; i < n; ++i) {
-            workers_.emplace_back([this] {
+            workers_.emplace_back([this, i, pin] {
+                if (pin) {
+                    topology::pinCurrentThread(topology::Topology::system().place(i));
+                }
+                context() = Context{this, i};
                 while (true) {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock lock{mutex_};
-                        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-                        if (stop_ && tasks_.empty()) return;
-                        task = std::move(tasks_.front());
-                        tasks_.pop();
-                    }
-                    task();
+                    if (runOne()) continue;
+
+                    std::unique_lock lock{sleepMutex_};
+                    sleepers_.fetch_add(1);
+                    wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+                    sleepers_.fetch_sub(1);
+                    if (stop_ && queued_.load() == 0) return;
                 }
             });
         }
@@ -63,12 +305,12 @@ private:
 
     void stop() {
         {
-            std::unique_lock lock{mutex_};
+            std::unique_lock lock{sleepMutex_};
             stop_ = true;
         }
-        cv_.notify_all();
+        wake_.notify_all();
         for (auto& worker : workers_) {
             if (worker.joinable()) worker.join();
         }
     }
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models", PPoPP 2013).
+//
+// One owner thread pushes and pops at the bottom (LIFO, cache-warm); any
+// thread may steal from the top (FIFO, oldest work first). Neither end takes
+// a lock: the owner only synchronizes with thieves when the deque is down to
+// its last element. T must be trivially copyable (the pool stores pointers).
+//
+// The ring grows by doubling when full. Retired rings are kept until the
+// deque is destroyed, since a thief may still be reading from one.
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements must be trivially copyable");
+
+public:
+    explicit WorkStealingDeque(std::int64_t capacity = 256) {
+        std::int64_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        rings_.push_back(std::make_unique<Ring>(rounded));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T item) {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        if (b - t > ring->capacity - 1) {
+            ring = grow(ring, b, t);
+        }
+        ring->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Takes the most recently pushed item.
+    bool pop(T& out) {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) { // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = ring->get(b);
+        if (t == b) {
+            // Last element: race thieves for it.
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the oldest item; fails if empty or if another thread
+    // won the race for it.
+    bool steal(T& out) {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+
+        Ring* ring = ring_.load(std::memory_order_acquire);
+        out = ring->get(t);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate when called concurrently with push/pop/steal.
+    [[nodiscard]] bool empty() const {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Ring {
+        explicit Ring(std::int64_t cap) : capacity{cap}, mask{cap - 1}, slots{new std::atomic<T>[cap]} {}
+
+        T get(std::int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, T item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+
+        const std::int64_t capacity;
+        const std::int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Ring* grow(Ring* ring, std::int64_t bottom, std::int64_t top) {
+        auto bigger = std::make_unique<Ring>(ring->capacity * 2);
+        for (std::int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, ring->get(i));
+        }
+        Ring* next = bigger.get();
+        rings_.push_back(std::move(bigger));
+        ring_.store(next, std::memory_order_release);
+        return next;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    alignas(64) std::atomic<Ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings_; // owner only; current ring is rings_.back()
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include "core/Bar.h"
+
+namespace indicators {
+
+// Average True Range with Wilder's smoothing. The first value is the simple
+// average of the first `period` true ranges.
+class Atr {
+public:
+    explicit Atr(std::size_t period) : period_{period} {
+        if (period_ == 0) {
+            throw std::invalid_argument("Atr period cannot be zero.");
+        }
+    }
+
+    double update(const Bar& bar) {
+        return update(bar.high, bar.low, bar.close);
+    }
+
+    double update(double high, double low, double close) {
+        double trueRange = high - low;
+        if (hasPrevClose_) {
+            trueRange = std::max({trueRange, std::abs(high - prevClose_), std::abs(low - prevClose_)});
+        }
+        prevClose_ = close;
+        hasPrevClose_ = true;
+
+        const double n = static_cast<double>(period_);
+        if (count_ < period_) {
+            ++count_;
+            value_ += (trueRange - value_) / static_cast<double>(count_);
+        } else {
+            value_ = (value_ * (n - 1.0) + trueRange) / n;
+        }
+        return value_;
+    }
+
+    [[nodiscard]] bool ready() const { return count_ >= period_; }
+    [[nodiscard]] double value() const { return value_; }
+    [[nodiscard]] std::size_t period() const { return period_; }
+
+private:
+    std::size_t period_;
+    std::size_t count_{0};
+    double value_{0.0};
+    double prevClose_{0.0};
+    bool hasPrevClose_{false};
+};
+
+} // namespace indicators
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "core/Bar.h"
+
+// Batch indicator kernels over whole histories stored as contiguous double
+// columns. Every kernel writes into a caller-provided array of the same length
+// as its input; positions without a full window are set to NaN.
+//
+// The loops are written for the compiler's auto-vectorizer (the build passes
+// -march=native, so AVX2/AVX-512 is picked up where available):
+//  - element-wise kernels (returns) are plain independent loops over restrict
+//    pointers;
+//  - rolling kernels split each tile into kLanes independent segments, each
+//    anchored with an exact window sum, and advance them in lockstep. That
+//    replaces one long loop-carried add chain by kLanes independent ones and
+//    re-anchors every kSegment outputs, which bounds rounding drift.
+// EMA is a first-order recurrence with no independent work to split, so it
+// stays a single scalar pass.
+namespace indicators::batch {
+
+inline constexpr std::size_t kLanes = 8;
+inline constexpr std::size_t kSegment = 512;
+
+// Copies one field of every bar into out (out must hold bars.size() values).
+template <typename Field>
+void extractColumn(const std::vector<Bar>& bars, Field Bar::*field, double* __restrict out) {
+    const std::size_t n = bars.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<double>(bars[i].*field);
+    }
+}
+
+template <typename Field>
+std::vector<double> column(const std::vector<Bar>& bars, Field Bar::*field) {
+    std::vector<double> out(bars.size());
+    extractColumn(bars, field, out.data());
+    return out;
+}
+
+namespace detail {
+
+inline void requirePeriod(std::size_t period) {
+    if (period == 0) {
+        throw std::invalid_argument("Batch indicator period cannot be zero.");
+    }
+}
+
+inline void fillNaN(double* out, std::size_t count) {
+    std::fill(out, out + count, std::numeric_limits<double>::quiet_NaN());
+}
+
+// Sum of in[end - period + 1 .. end], shifted by `shift`.
+inline double windowSum(const double* in, std::size_t end, std::size_t period, double shift = 0.0) {
+    double sum = 0.0;
+    for (std::size_t k = end + 1 - period; k <= end; ++k) {
+        sum += in[k] - shift;
+    }
+    return sum;
+}
+
+inline double windowSumSq(const double* in, std::size_t end, std::size_t period, double shift) {
+    double sum = 0.0;
+    for (std::size_t k = end + 1 - period; k <= end; ++k) {
+        const double d = in[k] - shift;
+        sum += d * d;
+    }
+    return sum;
+}
+
+} // namespace detail
+
+// Simple moving average: out[i] = mean(in[i - period + 1 .. i]).
+inline void sma(const double* __restrict in, std::size_t n, std::size_t period, double* __restrict out) {
+    detail::requirePeriod(period);
+    if (n == 0) return;
+    detail::fillNaN(out, std::min(n, period - 1));
+    if (n < period) return;
+
+    const double inv = 1.0 / static_cast<double>(period);
+    std::size_t i = period - 1;
+
+    for (; i + kLanes * kSegment <= n; i += kLanes * kSegment) {
+        double sum[kLanes];
+        for (std::size_t j = 0; j < kLanes; ++j) {
+            const std::size_t start = i + j * kSegment;
+            sum[j] = detail::windowSum(in, start, period);
+            out[start] = sum[j] * inv;
+        }
+        for (std::size_t t = 1; t < kSegment; ++t) {
+            for (std::size_t j = 0; j < kLanes; ++j) {
+                const std::size_t x = i + j * kSegment + t;
+                sum[j] += in[x] - in[x - period];
+                out[x] = sum[j] * inv;
+            }
+        }
+    }
+
+    // Tail shorter than one tile.
+    if (i < n) {
+        double sum = detail::windowSum(in, i, period);
+        out[i] = sum * inv;
+        for (std::size_t x = i + 1; x < n; ++x) {
+            sum += in[x] - in[x - period];
+            out[x] = sum * inv;
+        }
+    }
+}
+
+// Exponential moving average with alpha = 2 / (period + 1), seeded with the SMA
+// of the first `period` values (same convention as indicators::Ema).
+inline void ema(const double* __restrict in, std::size_t n, std::size_t period, double* __restrict out) {
+    detail::requirePeriod(period);
+    if (n == 0) return;
+    detail::fillNaN(out, std::min(n, period - 1));
+    if (n < period) return;
+
+    const double alpha = 2.0 / (static_cast<double>(period) + 1.0);
+    double value = detail::windowSum(in, period - 1, period) / static_cast<double>(period);
+    out[period - 1] = value;
+    for (std::size_t i = period; i < n; ++i) {
+        value += alpha * (in[i] - value);
+        out[i] = value;
+    }
+}
+
+// Rolling population standard deviation over `period` values. Each segment is
+// shifted by its first input value before summing x and x^2, which keeps the
+// sum-of-squares formula well conditioned for price-level data.
+inline void rollingStdDev(const double* __restrict in, std::size_t n, std::size_t period, double* __restrict out) {
+    detail::requirePeriod(period);
+    if (n == 0) return;
+    detail::fillNaN(out, std::min(n, period - 1));
+    if (n < period) return;
+
+    const double inv = 1.0 / static_cast<double>(period);
+    auto finish = [inv](double sum, double sumSq) {
+        const double mean = sum * inv;
+        return std::sqrt(std::max(sumSq * inv - mean * mean, 0.0));
+    };
+
+    std::size_t i = period - 1;
+    for (; i + kLanes * kSegment <= n; i += kLanes * kSegment) {
+        double shift[kLanes];
+        double sum[kLanes];
+        double sumSq[kLanes];
+        for (std::size_t j = 0; j < kLanes; ++j) {
+            const std::size_t start = i + j * kSegment;
+            shift[j] = in[start];
+            sum[j] = detail::windowSum(in, start, period, shift[j]);
+            sumSq[j] = detail::windowSumSq(in, start, period, shift[j]);
+            out[start] = finish(sum[j], sumSq[j]);
+        }
+        for (std::size_t t = 1; t < kSegment; ++t) {
+            for (std::size_t j = 0; j < kLanes; ++j) {
+                const std::size_t x = i + j * kSegment + t;
+                const double added = in[x] - shift[j];
+                const double removed = in[x - period] - shift[j];
+                sum[j] += added - removed;
+                sumSq[j] += added * added - removed * removed;
+                out[x] = finish(sum[j], sumSq[j]);
+            }
+        }
+    }
+
+    if (i < n) {
+        const double shift = in[i];
+        double sum = detail::windowSum(in, i, period, shift);
+        double sumSq = detail::windowSumSq(in, i, period, shift);
+        out[i] = finish(sum, sumSq);
+        for (std::size_t x = i + 1; x < n; ++x) {
+            const double added = in[x] - shift;
+            const double removed = in[x - period] - shift;
+            sum += added - removed;
+            sumSq += added * added - removed * removed;
+            out[x] = finish(sum, sumSq);
+        }
+    }
+}
+
+// Simple returns: out[i] = in[i] / in[i - 1] - 1; out[0] = NaN.
+inline void returns(const double* __restrict in, std::size_t n, double* __restrict out) {
+    if (n == 0) return;
+    out[0] = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = 1; i < n; ++i) {
+        out[i] = in[i] / in[i - 1] - 1.0;
+    }
+}
+
+// Log returns: out[i] = ln(in[i] / in[i - 1]); out[0] = NaN.
+inline void logReturns(const double* __restrict in, std::size_t n, double* __restrict out) {
+    if (n == 0) return;
+    out[0] = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = 1; i < n; ++i) {
+        out[i] = std::log(in[i] / in[i - 1]);
+    }
+}
+
+} // namespace indicators::batch
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace indicators {
+
+// Exponential moving average with alpha = 2 / (period + 1), seeded with the
+// simple average of the first `period` values.
+class Ema {
+public:
+    explicit Ema(std::size_t period)
+        : period_{period}, alpha_{2.0 / (static_cast<double>(period) + 1.0)} {
+        if (period_ == 0) {
+            throw std::invalid_argument("Ema period cannot be zero.");
+        }
+    }
+
+    double update(double value) {
+        if (count_ < period_) {
+            seedSum_ += value;
+            ++count_;
+            value_ = seedSum_ / static_cast<double>(count_);
+        } else {
+            value_ += alpha_ * (value - value_);
+        }
+        return value_;
+    }
+
+    [[nodiscard]] bool ready() const { return count_ >= period_; }
+    [[nodiscard]] double value() const { return value_; }
+    [[nodiscard]] std::size_t period() const { return period_; }
+    [[nodiscard]] double alpha() const { return alpha_; }
+
+private:
+    std::size_t period_;
+    double alpha_;
+    double seedSum_{0.0};
+    double value_{0.0};
+    std::size_t count_{0};
+};
+
+} // namespace indicators
@@ -0,0 +1,11 @@
+#pragma once
+
+// Incremental O(1)-per-update indicators. Each keeps its state in fixed-capacity
+// storage allocated at construction; update() never allocates.
+#include "indicators/RingBuffer.h"
+#include "indicators/Sma.h"
+#include "indicators/Ema.h"
+#include "indicators/RollingMinMax.h"
+#include "indicators/RollingStdDev.h"
+#include "indicators/Atr.h"
+#include "indicators/Rsi.h"
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace indicators {
+
+// Fixed-capacity circular buffer. Storage is allocated once in the constructor;
+// push() never allocates and overwrites the oldest element when full.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t capacity)
+        : data_{std::make_unique<T[]>(capacity)}, capacity_{capacity} {
+        if (capacity_ == 0) {
+            throw std::invalid_argument("RingBuffer capacity cannot be zero.");
+        }
+    }
+
+    // Appends value. If the buffer was full, the evicted oldest element is
+    // written to *evicted (when non-null) and true is returned.
+    bool push(const T& value, T* evicted = nullptr) {
+        const bool wasFull = full();
+        if (wasFull && evicted) {
+            *evicted = data_[head_];
+        }
+        data_[head_] = value;
+        head_ = (head_ + 1 == capacity_) ? 0 : head_ + 1;
+        if (!wasFull) {
+            ++size_;
+        }
+        return wasFull;
+    }
+
+    // Removes the oldest element. The buffer must not be empty.
+    void pop_front() {
+        --size_;
+    }
+
+    // Removes the newest element. The buffer must not be empty.
+    void pop_back() {
+        head_ = (head_ == 0) ? capacity_ - 1 : head_ - 1;
+        --size_;
+    }
+
+    // i = 0 is the oldest element, size() - 1 the newest.
+    [[nodiscard]] const T& operator[](std::size_t i) const { return data_[physical(i)]; }
+    [[nodiscard]] T& operator[](std::size_t i) { return data_[physical(i)]; }
+
+    [[nodiscard]] const T& front() const { return (*this)[0]; }
+    [[nodiscard]] const T& back() const { return (*this)[size_ - 1]; }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] bool full() const { return size_ == capacity_; }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    std::size_t physical(std::size_t i) const {
+        const std::size_t p = head_ + capacity_ - size_ + i; // < 2 * capacity_
+        return p >= capacity_ ? p - capacity_ : p;
+    }
+
+    std::unique_ptr<T[]> data_;
+    std::size_t capacity_;
+    std::size_t head_{0}; // next write position
+    std::size_t size_{0};
+};
+
+} // namespace indicators
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "indicators/RingBuffer.h"
+
+namespace indicators {
+
+// Rolling extremum over the last `period` values using a monotonic deque:
+// each value is pushed and popped at most once, so updates are amortized O(1).
+// The deque lives in a fixed-capacity ring buffer (at most `period` entries).
+template <typename Compare>
+class RollingExtremum {
+public:
+    explicit RollingExtremum(std::size_t period) : period_{period}, deque_{period} {}
+
+    double update(double value) {
+        // Expire the front once it falls out of the window.
+        if (!deque_.empty() && deque_.front().index + period_ <= index_) {
+            deque_.pop_front();
+        }
+        // Drop candidates that can never be the extremum again.
+        while (!deque_.empty() && !Compare{}(deque_.back().value, value)) {
+            deque_.pop_back();
+        }
+        deque_.push({index_, value});
+        ++index_;
+        return deque_.front().value;
+    }
+
+    [[nodiscard]] bool ready() const { return index_ >= period_; }
+    [[nodiscard]] double value() const { return deque_.front().value; }
+    [[nodiscard]] std::size_t period() const { return period_; }
+
+private:
+    struct Entry {
+        std::uint64_t index;
+        double value;
+    };
+
+    std::size_t period_;
+    RingBuffer<Entry> deque_;
+    std::uint64_t index_{0};
+};
+
+using RollingMax = RollingExtremum<std::greater<double>>;
+using RollingMin = RollingExtremum<std::less<double>>;
+
+} // namespace indicators
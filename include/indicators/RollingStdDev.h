@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "indicators/RingBuffer.h"
+
+namespace indicators {
+
+// Rolling mean / variance / standard deviation over the last `period` values,
+// using Welford's update extended to a sliding window (add and replace), which
+// avoids the cancellation of the naive sum-of-squares formula.
+class RollingStdDev {
+public:
+    explicit RollingStdDev(std::size_t period) : window_{period} {}
+
+    // Adds a value and returns the population standard deviation of the window.
+    double update(double value) {
+        double evicted = 0.0;
+        if (window_.push(value, &evicted)) {
+            // Replace `evicted` by `value` in a window of constant size n.
+            const double n = static_cast<double>(window_.size());
+            const double oldMean = mean_;
+            mean_ += (value - evicted) / n;
+            m2_ += (value - evicted) * (value - mean_ + evicted - oldMean);
+        } else {
+            const double n = static_cast<double>(window_.size());
+            const double delta = value - mean_;
+            mean_ += delta / n;
+            m2_ += delta * (value - mean_);
+        }
+        m2_ = std::max(m2_, 0.0); // guard against rounding below zero
+        return stddev();
+    }
+
+    [[nodiscard]] bool ready() const { return window_.full(); }
+    [[nodiscard]] double mean() const { return mean_; }
+
+    // Population variance (divides by n).
+    [[nodiscard]] double variance() const {
+        return window_.empty() ? 0.0 : m2_ / static_cast<double>(window_.size());
+    }
+
+    // Sample variance (divides by n - 1).
+    [[nodiscard]] double sampleVariance() const {
+        return window_.size() < 2 ? 0.0 : m2_ / static_cast<double>(window_.size() - 1);
+    }
+
+    [[nodiscard]] double stddev() const { return std::sqrt(variance()); }
+    [[nodiscard]] double sampleStdDev() const { return std::sqrt(sampleVariance()); }
+    [[nodiscard]] std::size_t period() const { return window_.capacity(); }
+
+private:
+    RingBuffer<double> window_;
+    double mean_{0.0};
+    double m2_{0.0};
+};
+
+} // namespace indicators
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace indicators {
+
+// Relative Strength Index (0..100) with Wilder's smoothing of average gains and
+// losses. Needs period + 1 prices (period changes) before it is ready.
+class Rsi {
+public:
+    explicit Rsi(std::size_t period) : period_{period} {
+        if (period_ == 0) {
+            throw std::invalid_argument("Rsi period cannot be zero.");
+        }
+    }
+
+    double update(double price) {
+        if (!hasPrev_) {
+            prev_ = price;
+            hasPrev_ = true;
+            return value_;
+        }
+
+        const double change = price - prev_;
+        prev_ = price;
+        const double gain = change > 0 ? change : 0.0;
+        const double loss = change < 0 ? -change : 0.0;
+
+        const double n = static_cast<double>(period_);
+        if (count_ < period_) {
+            ++count_;
+            avgGain_ += (gain - avgGain_) / static_cast<double>(count_);
+            avgLoss_ += (loss - avgLoss_) / static_cast<double>(count_);
+        } else {
+            avgGain_ = (avgGain_ * (n - 1.0) + gain) / n;
+            avgLoss_ = (avgLoss_ * (n - 1.0) + loss) / n;
+        }
+
+        if (avgLoss_ == 0.0) {
+            value_ = avgGain_ == 0.0 ? 50.0 : 100.0;
+        } else {
+            value_ = 100.0 - 100.0 / (1.0 + avgGain_ / avgLoss_);
+        }
+        return value_;
+    }
+
+    [[nodiscard]] bool ready() const { return count_ >= period_; }
+    [[nodiscard]] double value() const { return value_; }
+    [[nodiscard]] std::size_t period() const { return period_; }
+
+private:
+    std::size_t period_;
+    std::size_t count_{0};
+    double prev_{0.0};
+    bool hasPrev_{false};
+    double avgGain_{0.0};
+    double avgLoss_{0.0};
+    double value_{50.0};
+};
+
+} // namespace indicators
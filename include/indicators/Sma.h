@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include "indicators/RingBuffer.h"
+
+namespace indicators {
+
+// Simple moving average over the last `period` values, O(1) per update via a
+// rolling sum. The sum is recomputed exactly once per `period` updates, which
+// keeps floating-point drift bounded at amortized O(1) cost.
+class Sma {
+public:
+    explicit Sma(std::size_t period) : window_{period} {}
+
+    // Adds a value and returns the current average (of the values seen so far
+    // while warming up).
+    double update(double value) {
+        double evicted = 0.0;
+        if (window_.push(value, &evicted)) {
+            sum_ += value - evicted;
+        } else {
+            sum_ += value;
+        }
+        if (++sinceResum_ == window_.capacity()) {
+            sum_ = 0.0;
+            for (std::size_t i = 0; i < window_.size(); ++i) {
+                sum_ += window_[i];
+            }
+            sinceResum_ = 0;
+        }
+        return value_ = sum_ / static_cast<double>(window_.size());
+    }
+
+    // True once `period` values have been seen.
+    [[nodiscard]] bool ready() const { return window_.full(); }
+    [[nodiscard]] double value() const { return value_; }
+    [[nodiscard]] std::size_t period() const { return window_.capacity(); }
+
+private:
+    RingBuffer<double> window_;
+    double sum_{0.0};
+    double value_{0.0};
+    std::size_t sinceResum_{0};
+};
+
+} // namespace indicators
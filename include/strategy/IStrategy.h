@@ -1,11 +1,15 @@
 #pragma once
 
 #include "strategy/StrategyConfig.h"
+#include <cstddef>
+#include <span>
 #include <vector>
 #include "core/Bar.h"
+#include "core/BarSeries.h"
 #include "core/Position.h"
 #include "core/OrderRequest.h"
 #include "strategy/StrategyAction.h"
+#include "strategy/Signal.h"
 
 class IStrategy {
 public:
@@ -20,4 +24,16 @@ public:
     virtual void on_finish() = 0;
 
     virtual const StrategyConfig& getConfig() const = 0;
+
+    // Optional batch interface for signal-based strategies. When supportsBatch()
+    // is true and the engine has the whole series, it calls on_batch for
+    // consecutive windows [begin, end) instead of on_bar, and applies the
+    // signals itself (see Signal for their semantics). bars holds the full
+    // series, so bars before begin are available as lookback. out has
+    // end - begin entries, all Hold on entry. on_bar is still used when bars
+    // are streamed, so a batch strategy must implement both consistently.
+    virtual bool supportsBatch() const { return false; }
+
+    virtual void on_batch(const BarSeries& /*bars*/, std::size_t /*begin*/, std::size_t /*end*/,
+                          std::span<Signal> /*out*/) {}
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Compact per-bar output of IStrategy::on_batch.
+//
+// Flags state intent relative to the positions the engine holds when it applies
+// the signal (after stop-loss/take-profit checks): an exit closes every open
+// position of that side, and an entry is taken only if the book had room
+// (fewer than StrategyConfig::maxOpenPositions) before this bar's exits - with
+// the default of one, only when flat. That mirrors on_bar, where a strategy
+// sees the open positions before deciding, so signal-based strategies can
+// precompute every bar without knowing the engine's state.
+struct Signal {
+    enum Flags : std::uint8_t {
+        Hold       = 0,
+        ExitLong   = 1 << 0,
+        ExitShort  = 1 << 1,
+        EnterLong  = 1 << 2,
+        EnterShort = 1 << 3,
+    };
+
+    std::uint8_t flags{Hold};
+    double sizeUsd{0.0}; // notional of the entry, if any
+};
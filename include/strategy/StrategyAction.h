@@ -1,13 +1,73 @@
 #pragma once
 
 #include "core/OrderRequest.h"
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 
-// Defines the set of actions a strategy can request on a given bar.
+// Fixed-capacity list stored inline, so building, returning and consuming a
+// StrategyAction never allocates.
+template <typename T, std::size_t Capacity>
+class InlineList {
+public:
+    static constexpr std::size_t kCapacity = Capacity;
+
+    // Throws std::length_error once kCapacity elements have been added.
+    void push_back(const T& value) {
+        if (size_ == kCapacity) {
+            throw std::length_error("A StrategyAction list holds at most " + std::to_string(kCapacity) +
+                                    " entries per bar.");
+        }
+        items_[size_++] = value;
+    }
+
+    void clear() { size_ = 0; }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+
+    const T& operator[](std::size_t i) const { return items_[i]; }
+    T& operator[](std::size_t i) { return items_[i]; }
+
+    const T* begin() const { return items_.data(); }
+    const T* end() const { return items_.data() + size_; }
+    T* begin() { return items_.data(); }
+    T* end() { return items_.data() + size_; }
+
+private:
+    std::array<T, Capacity> items_{};
+    std::size_t size_{0};
+};
+
+using OrderList = InlineList<OrderRequest, 4>;
+using PositionIdList = InlineList<std::uint64_t, 16>;
+using OrderIdList = InlineList<std::uint64_t, 16>;
+
+// Defines the set of actions a strategy can request on a given bar. Closes are
+// applied first, then cancels, replacements and new orders.
 struct StrategyAction {
-    // A list of new orders to be opened.
-    std::vector<OrderRequest> openRequests;
+    // New orders (at most OrderList::kCapacity per bar). Market orders fill at
+    // the close; others rest in the order book. Fills beyond
+    // StrategyConfig::maxOpenPositions are dropped.
+    OrderList openRequests;
 
-    // If true, signals the engine to close the currently open position.
+    // If true, signals the engine to close the oldest open position.
     bool closeCurrentPosition{false};
-}; 
\ No newline at end of file
+
+    // If true, closes every open position (closePositionIds is then ignored).
+    bool closeAllPositions{false};
+
+    // Closes the positions with these ids (see Position::id); unknown ids are ignored.
+    PositionIdList closePositionIds;
+
+    // Cancels resting orders by OrderRequest::id; unknown ids are ignored.
+    OrderIdList cancelOrderIds;
+
+    // Replaces the resting order with the same OrderRequest::id (price, size,
+    // expiry, ...). Ignored if that order already filled, expired or was cancelled.
+    // A Market replacement cancels the order and fills at the close instead,
+    // like a Market entry in openRequests.
+    OrderList replaceRequests;
+};
@@ -1,10 +1,64 @@
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
 #include <string>
 
+// How the engine orders the prices inside a bar when resolving stops, targets
+// and resting orders.
+enum class IntrabarPath {
+    StopFirst,        // stop-losses, then take-profits, both filled at their level; resting
+                      // orders follow Auto. The historical behaviour and the default.
+    OpenHighLowClose, // O -> H -> L -> C for everything, gaps at the open fill at the open
+    OpenLowHighClose, // O -> L -> H -> C for everything
+    Auto,             // O -> L -> H -> C for up bars (close >= open), O -> H -> L -> C otherwise
+};
+
+// Trading costs, read from the optional "costs" object in config.json. All
+// rates are fractions (0.0004 = 4 bps); the defaults model a frictionless venue.
+struct CostConfig {
+    double makerFeeRate{0.0};         // fee on fills that rested in the book
+    double takerFeeRate{0.0};         // fee on market/stop fills and stop-loss exits
+    double slippageBps{0.0};          // fixed adverse slippage on taker fills, in basis points
+    double volumeImpact{0.0};         // extra slippage per unit of order quantity / bar volume
+    double fundingRate{0.0};          // paid by longs to shorts each funding interval
+    double fundingIntervalHours{8.0};
+};
+
 struct StrategyConfig {
     double initialCapital{10000.0};
     double stopLossPercent{0.0};
     double takeProfitPercent{0.0};
     double perTradeSize{0.0};
-}; 
\ No newline at end of file
+
+    // Upper bound on simultaneously open positions (pyramiding / grid legs).
+    // The default of one keeps a single position per symbol.
+    std::size_t maxOpenPositions{1};
+
+    // config.json "intrabarPath": "stop_first", "ohlc", "olhc" or "auto".
+    IntrabarPath intrabarPath{IntrabarPath::StopFirst};
+
+    CostConfig costs;
+
+    // Strategy-specific numeric parameters (e.g. "smaPeriod"), read from the
+    // optional "params" object in config.json.
+    std::map<std::string, double> params;
+
+    // Validates a maxOpenPositions value from config.json or a parameter grid:
+    // throws std::invalid_argument unless it is a whole number >= 1.
+    static std::size_t positionCount(double value) {
+        if (!(value >= 1.0) || std::trunc(value) != value || value > 1e9) {
+            throw std::invalid_argument("maxOpenPositions must be a whole number >= 1, got " +
+                                        std::to_string(value));
+        }
+        return static_cast<std::size_t>(value);
+    }
+
+    // Returns params[key], or fallback if the strategy config does not set it.
+    double param(const std::string& key, double fallback) const {
+        auto it = params.find(key);
+        return it != params.end() ? it->second : fallback;
+    }
+};
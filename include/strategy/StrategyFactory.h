@@ -16,9 +16,18 @@ public:
     // Registers a new strategy creation method.
     void registerStrategy(const std::string& name, TCreateMethod createMethod);
 
-    // Creates a strategy instance by name.
+    // Creates a strategy instance by name, configured from its config.json.
     std::shared_ptr<IStrategy> createStrategy(const std::string& name);
 
+    // Creates a strategy instance by name with an explicit configuration.
+    std::shared_ptr<IStrategy> createStrategy(const std::string& name, const StrategyConfig& config) const;
+
+    // Loads strategies/<name>/config.json.
+    StrategyConfig loadConfig(const std::string& name) const;
+
+    // Returns the registered creation method, throwing if the name is unknown.
+    const TCreateMethod& getCreateMethod(const std::string& name) const;
+
     // Returns a list of all registered strategy names.
     std::vector<std::string> getRegisteredStrategies() const;
 
@@ -1,18 +1,64 @@
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "data/Aggregator.h"
 #include "data/PriceManager.h"
+#include "engine/BacktestManager.h"
 #include "engine/ExecutionEngine.h"
+#include "engine/ParameterGrid.h"
+#include "engine/PortfolioEngine.h"
+#include "core/Log.h"
+#include "core/ResultsWriter.h"
 #include "strategy/StrategyFactory.h"
 #include "buy_and_hold/BuyAndHoldStrategy.h" // Include the strategy
 #include "sma_cross/SmaCrossStrategy.h"
 
+std::vector<std::string> splitSymbols(const std::string& list) {
+    std::vector<std::string> symbols;
+    std::stringstream ss(list);
+    std::string symbol;
+    while (std::getline(ss, symbol, ',')) {
+        if (!symbol.empty()) {
+            symbols.push_back(symbol);
+        }
+    }
+    return symbols;
+}
+
+// Loads 1-minute data for symbol and aggregates it to the trading resolution.
+std::vector<Bar> loadBars(const std::string& symbol, int targetResolution, long from, long to) {
+    // Always fetch 1-minute data from the source to ensure we have the finest
+    // granularity for aggregation.
+    const std::string fetchResolution = "1";
+    PriceManager priceManager(symbol, fetchResolution, from, to);
+    auto rawBars = priceManager.loadData();
+    if (rawBars.empty()) {
+        return {};
+    }
+
+    Aggregator aggregator(targetResolution);
+    auto tradeBars = aggregator.aggregate(rawBars);
+    LOG_INFO << symbol << ": aggregated " << rawBars.size() << " raw bars into "
+             << tradeBars.size() << " " << targetResolution << "-minute bars.";
+    return tradeBars;
+}
+
 void printUsage(const StrategyFactory& factory) {
-    std::cout << "Usage: ./backtest_runner <symbol> <resolution_minutes> <from_timestamp> <to_timestamp> <strategy_name>\n"
-              << "Example: ./backtest_runner Crypto.BTC/USD 1 1684137600 1684141200 buy_and_hold\n\n"
+    std::cout << "Usage: ./backtest_runner <symbol[,symbol...]> <resolution_minutes> <from_timestamp> <to_timestamp> <strategy_name> [--sweep <grid.json>] [--threads <n>] [--numa] [--results <path>] [--log-level <level>]\n"
+              << "Example: ./backtest_runner Crypto.BTC/USD 1 1684137600 1684141200 buy_and_hold\n"
+              << "  Several comma-separated symbols are backtested together against one shared account,\n"
+              << "  e.g. Crypto.BTC/USD,Crypto.ETH/USD (one strategy instance per symbol).\n"
+              << "  --sweep <grid.json>  Run every combination of the parameter grid in parallel, e.g.\n"
+              << "                       {\"stopLossPercent\": [1, 2], \"smaPeriod\": [10, 20, 30]}\n"
+              << "  --threads <n>        Sweep worker threads (default: all cores)\n"
+              << "  --numa               Pin sweep workers across NUMA nodes, each node reading its own copy of the bars\n"
+              << "  --results <path>     Also write machine-readable results: <path>.json plus\n"
+              << "                       <path>.trades.csv and <path>.equity.csv (or <path>.csv for a sweep)\n"
+              << "  --log-level <level>  trace, debug (per-trade lines), info (default), warn, error or off\n\n"
               << "Available strategies:\n";
     for (const auto& name : factory.getRegisteredStrategies()) {
         std::cout << " - " << name << "\n";
@@ -31,45 +77,120 @@ int main(int argc, char* argv[]) {
     // --- Register new strategies here ---
 
 
-    if (argc != 6) {
+    if (argc < 6) {
         printUsage(factory);
         return 1;
     }
+    std::string sweepPath;
+    std::string resultsPath;
+    RunnerOptions runnerOptions;
+    for (int i = 6; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if ((flag == "--sweep" || flag == "--results") && i + 1 < argc) {
+            (flag == "--sweep" ? sweepPath : resultsPath) = argv[++i];
+        } else if (flag == "--threads" && i + 1 < argc) {
+            runnerOptions.threads = std::strtoull(argv[++i], nullptr, 10);
+            if (runnerOptions.threads == 0) {
+                printUsage(factory);
+                return 1;
+            }
+        } else if (flag == "--numa") {
+            runnerOptions.pinThreads = true;
+            runnerOptions.replicatePerNode = true;
+        } else if (flag == "--log-level" && i + 1 < argc) {
+            try {
+                logging::setLevel(logging::parseLevel(argv[++i]));
+            } catch (const std::invalid_argument&) {
+                printUsage(factory);
+                return 1;
+            }
+        } else {
+            printUsage(factory);
+            return 1;
+        }
+    }
 
     try {
-        std::string symbol = argv[1];
+        const auto symbols = splitSymbols(argv[1]);
         int targetResolution = std::stoi(argv[2]); // The resolution we want to trade on
         long from = std::stol(argv[3]);
         long to = std::stol(argv[4]);
         std::string strategyName = argv[5];
+        if (symbols.empty()) {
+            printUsage(factory);
+            return 1;
+        }
+
+        // Portfolio: one strategy per symbol, all trading one shared account
+        if (symbols.size() > 1) {
+            if (!sweepPath.empty()) {
+                LOG_ERROR << "--sweep runs over a single symbol.";
+                return 1;
+            }
+            PortfolioEngine portfolio(factory.loadConfig(strategyName).initialCapital);
+            for (const auto& symbol : symbols) {
+                auto bars = loadBars(symbol, targetResolution, from, to);
+                if (bars.empty()) {
+                    LOG_ERROR << "No data loaded for " << symbol << ". Exiting.";
+                    return 1;
+                }
+                portfolio.addSymbol(symbol, factory.createStrategy(strategyName), BarSeries::fromBars(bars));
+            }
+            if (!resultsPath.empty()) {
+                portfolio.recordEquityCurve();
+            }
+            LOG_INFO << "\n--- Running Portfolio Backtest (" << symbols.size() << " symbols) ---";
+            portfolio.run();
+            LOG_INFO << "--- Backtest Finished ---";
+            if (!resultsPath.empty()) {
+                results::writeRun(resultsPath, portfolio.account(), {strategyName + " " + argv[1], {}});
+                LOG_INFO << "Results written to " << resultsPath << ".json";
+            }
+            return 0;
+        }
 
-        // 1. Get Data - Always fetch 1-minute data from the source to ensure we have
-        // the finest granularity for aggregation.
-        const std::string fetchResolution = "1";
-        PriceManager priceManager(symbol, fetchResolution, from, to);
-        auto rawBars = priceManager.loadData();
-        if (rawBars.empty()) {
-            std::cerr << "No data loaded for the given parameters. Exiting." << std::endl;
+        // 1-2. Get Data and aggregate it to the user's desired trading resolution
+        auto tradeBars = loadBars(symbols.front(), targetResolution, from, to);
+        if (tradeBars.empty()) {
+            LOG_ERROR << "No data loaded for the given parameters. Exiting.";
             return 1;
         }
 
-        // 2. Aggregate Data to the user's desired trading resolution
-        Aggregator aggregator(targetResolution);
-        auto tradeBars = aggregator.aggregate(rawBars);
-        std::cout << "Aggregated " << rawBars.size() << " raw bars into " 
-                  << tradeBars.size() << " " << targetResolution << "-minute bars.\n";
+        // 3a. Parameter sweep: every combination runs over the same aggregated bars
+        if (!sweepPath.empty()) {
+            auto grid = ParameterGrid::fromJsonFile(sweepPath);
+            auto sharedBars = std::make_shared<const std::vector<Bar>>(std::move(tradeBars));
+            LOG_INFO << "\n--- Running Parameter Sweep (" << grid.size() << " combinations) ---";
+            auto ranked = BacktestManager::sweep(sharedBars, grid, factory.loadConfig(strategyName),
+                                                 factory.getCreateMethod(strategyName), runnerOptions);
+            BacktestManager::printSweepResults(ranked, grid);
+            if (!resultsPath.empty()) {
+                results::writeSweep(resultsPath, BacktestManager::sweepRows(ranked, grid));
+                LOG_INFO << "Results written to " << resultsPath << ".json";
+            }
+            return 0;
+        }
 
         // 3. Set up Strategy and Engine
         auto strategy = factory.createStrategy(strategyName);
         ExecutionEngine engine(strategy);
+        if (!resultsPath.empty()) {
+            engine.recordEquityCurve(tradeBars.size());
+        }
 
         // 4. Run Backtest
-        std::cout << "\n--- Running Backtest ---\n";
+        LOG_INFO << "\n--- Running Backtest ---";
         engine.run(tradeBars);
-        std::cout << "--- Backtest Finished ---\n";
+        LOG_INFO << "--- Backtest Finished ---";
+
+        // 5. Machine-readable output, written once the run is complete
+        if (!resultsPath.empty()) {
+            results::writeRun(resultsPath, engine.account(), {strategyName + " " + symbols.front(), {}});
+            LOG_INFO << "Results written to " << resultsPath << ".json";
+        }
 
     } catch (const std::exception& e) {
-        std::cerr << "An error occurred: " << e.what() << std::endl;
+        LOG_ERROR << "An error occurred: " << e.what();
         return 1;
     }
 
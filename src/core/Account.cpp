@@ -1,81 +1,103 @@
 #include "core/Account.h"
+#include "core/Log.h"
 #include <iostream>
 #include <iomanip>
-#include <numeric>
 #include <cmath>
 #include <algorithm>
 
-Account::Account(double initialBalance) : initialBalance_(initialBalance), balance_(initialBalance) {}
+Account::Account(double initialBalance)
+    : initialBalance_(initialBalance), balance_(initialBalance), equity_(initialBalance) {}
 
 void Account::recordTrade(const Trade& trade) {
     closedTrades_.push_back(trade);
     balance_ += trade.pnl; // Update balance with the result of the trade
+    equity_.addTraded(trade.sizeAmount * (trade.entryPrice + trade.exitPrice));
 }
 
-void Account::printSummary() const {
+AccountSummary Account::summarize() const {
+    AccountSummary summary;
+    summary.initialBalance = initialBalance_;
+    summary.finalBalance = balance_;
+    summary.netPnl = balance_ - initialBalance_;
+    summary.totalTrades = static_cast<int>(closedTrades_.size());
+    summary.risk = equity_.summarize();
     if (closedTrades_.empty()) {
-        std::cout << "\n--- No Trades Executed ---\n";
-        std::cout << "Starting Balance: " << std::fixed << std::setprecision(2) << initialBalance_ << std::endl;
-        std::cout << "Ending Balance:   " << std::fixed << std::setprecision(2) << balance_ << std::endl;
-        return;
+        return summary;
     }
 
-    int totalTrades = closedTrades_.size();
     int winCount = 0;
-    double grossPnl = 0.0;
-    
-    int longTrades = 0;
-    double netPnlLong = 0.0;
-    int shortTrades = 0;
-    double netPnlShort = 0.0;
-
-    std::vector<double> pnlValues;
-    pnlValues.reserve(totalTrades);
-
+    double sqSum = 0.0;
     for (const auto& trade : closedTrades_) {
-        pnlValues.push_back(trade.pnl);
-        grossPnl += std::abs(trade.pnl);
+        sqSum += trade.pnl * trade.pnl;
+        summary.grossPnl += std::abs(trade.pnl);
+        summary.totalFees += trade.fee;
+        summary.totalFunding += trade.funding;
         if (trade.pnl > 0) {
             winCount++;
         }
         if (trade.side == Side::Long) {
-            longTrades++;
-            netPnlLong += trade.pnl;
+            summary.longTrades++;
+            summary.netPnlLong += trade.pnl;
         } else {
-            shortTrades++;
-            netPnlShort += trade.pnl;
+            summary.shortTrades++;
+            summary.netPnlShort += trade.pnl;
         }
     }
 
-    double netPnl = balance_ - initialBalance_;
-    double winLossRatio = (totalTrades > 0) ? static_cast<double>(winCount) / totalTrades : 0.0;
+    const int totalTrades = summary.totalTrades;
+    summary.winRate = static_cast<double>(winCount) / totalTrades;
 
     // Sharpe Ratio Calculation
-    double pnlMean = netPnl / totalTrades;
+    double pnlMean = summary.netPnl / totalTrades;
     double pnlStdDev = 0.0;
     if (totalTrades > 1) {
-        double sq_sum = std::inner_product(pnlValues.begin(), pnlValues.end(), pnlValues.begin(), 0.0);
-        pnlStdDev = std::sqrt(sq_sum / totalTrades - pnlMean * pnlMean);
+        pnlStdDev = std::sqrt(sqSum / totalTrades - pnlMean * pnlMean);
     }
-    double sharpeRatio = (pnlStdDev > 0) ? pnlMean / pnlStdDev : 0.0;
+    summary.sharpeRatio = (pnlStdDev > 0) ? pnlMean / pnlStdDev : 0.0;
 
+    return summary;
+}
+
+void Account::printSummary() const {
+    logging::flush(); // earlier log lines first
+    if (closedTrades_.empty()) {
+        std::cout << "\n--- No Trades Executed ---\n";
+        std::cout << "Starting Balance: " << std::fixed << std::setprecision(2) << initialBalance_ << std::endl;
+        std::cout << "Ending Balance:   " << std::fixed << std::setprecision(2) << balance_ << std::endl;
+        return;
+    }
+
+    const AccountSummary s = summarize();
 
     // --- Print Summary ---
     std::cout << "\n--- Backtest Summary ---\n";
     std::cout << std::left << std::setw(20) << "Metric" << "Value\n";
     std::cout << "-----------------------------------\n";
     std::cout << std::fixed << std::setprecision(2);
-    std::cout << std::left << std::setw(20) << "Starting Balance:" << initialBalance_ << "\n";
-    std::cout << std::left << std::setw(20) << "Ending Balance:" << balance_ << "\n";
-    std::cout << std::left << std::setw(20) << "Net PNL:" << netPnl << "\n";
-    std::cout << std::left << std::setw(20) << "Gross PNL:" << grossPnl << "\n";
-    std::cout << std::left << std::setw(20) << "Total Trades:" << totalTrades << "\n";
-    std::cout << std::left << std::setw(20) << "Win/Loss Ratio:" << winLossRatio * 100 << "%\n";
-    std::cout << std::left << std::setw(20) << "Sharpe Ratio:" << sharpeRatio << "\n";
+    std::cout << std::left << std::setw(20) << "Starting Balance:" << s.initialBalance << "\n";
+    std::cout << std::left << std::setw(20) << "Ending Balance:" << s.finalBalance << "\n";
+    std::cout << std::left << std::setw(20) << "Net PNL:" << s.netPnl << "\n";
+    std::cout << std::left << std::setw(20) << "Gross PNL:" << s.grossPnl << "\n";
+    std::cout << std::left << std::setw(20) << "Fees Paid:" << s.totalFees << "\n";
+    std::cout << std::left << std::setw(20) << "Funding Paid:" << s.totalFunding << "\n";
+    std::cout << std::left << std::setw(20) << "Total Trades:" << s.totalTrades << "\n";
+    std::cout << std::left << std::setw(20) << "Win/Loss Ratio:" << s.winRate * 100 << "%\n";
+    std::cout << std::left << std::setw(20) << "Trade Sharpe:" << s.sharpeRatio << "\n";
     std::cout << "-----------------------------------\n";
-    std::cout << std::left << std::setw(20) << "Total Long Trades:" << longTrades << "\n";
-    std::cout << std::left << std::setw(20) << "Net PNL Long:" << netPnlLong << "\n";
-    std::cout << std::left << std::setw(20) << "Total Short Trades:" << shortTrades << "\n";
-    std::cout << std::left << std::setw(20) << "Net PNL Short:" << netPnlShort << "\n";
+    if (s.risk.bars > 0) {
+        std::cout << std::left << std::setw(20) << "Final Equity:" << s.risk.finalEquity << "\n";
+        std::cout << std::left << std::setw(20) << "Annual Return:" << s.risk.annualReturn * 100 << "%\n";
+        std::cout << std::left << std::setw(20) << "Max Drawdown:" << s.risk.maxDrawdown * 100 << "%\n";
+        std::cout << std::left << std::setw(20) << "Sharpe (ann.):" << s.risk.sharpe << "\n";
+        std::cout << std::left << std::setw(20) << "Sortino (ann.):" << s.risk.sortino << "\n";
+        std::cout << std::left << std::setw(20) << "Calmar:" << s.risk.calmar << "\n";
+        std::cout << std::left << std::setw(20) << "Exposure:" << s.risk.exposure * 100 << "%\n";
+        std::cout << std::left << std::setw(20) << "Turnover:" << s.risk.turnover << "x\n";
+        std::cout << "-----------------------------------\n";
+    }
+    std::cout << std::left << std::setw(20) << "Total Long Trades:" << s.longTrades << "\n";
+    std::cout << std::left << std::setw(20) << "Net PNL Long:" << s.netPnlLong << "\n";
+    std::cout << std::left << std::setw(20) << "Total Short Trades:" << s.shortTrades << "\n";
+    std::cout << std::left << std::setw(20) << "Net PNL Short:" << s.netPnlShort << "\n";
     std::cout << "-----------------------------------\n";
-} 
\ No newline at end of file
+}
@@ -0,0 +1,218 @@
+#include "core/Log.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace logging {
+
+namespace {
+
+constexpr std::size_t kHandOffBytes = 8 * 1024;
+
+// Longest a line waits in an idle thread's buffer before it is written.
+constexpr std::chrono::milliseconds kHandOffInterval{100};
+
+std::atomic<int> gLevel{static_cast<int>(Level::Info)};
+
+enum Channel { Out = 0, Err = 1 };
+
+struct ThreadBuffer;
+
+// Every live thread's buffer, so flush() and the flusher's timer can collect
+// lines other threads have not handed off yet.
+struct Registry {
+    std::mutex mutex;
+    std::set<ThreadBuffer*> buffers;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Hands off every registered thread's pending lines.
+void collectAll();
+
+// Background writer. Threads hand it whole buffers; it writes them in
+// hand-off order and signals flush() waiters once they are out. Every
+// kHandOffInterval it also collects the buffers of threads that are
+// logging too slowly to fill one, so progress lines show up promptly.
+class Flusher {
+public:
+    Flusher() : thread_{[this] { loop(); }} {}
+
+    ~Flusher() {
+        {
+            std::lock_guard lock{mutex_};
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void submit(Channel channel, std::string&& text) {
+        {
+            std::lock_guard lock{mutex_};
+            queue_.emplace_back(channel, std::move(text));
+            ++submitted_;
+        }
+        wake_.notify_one();
+    }
+
+    // Blocks until the first `ticket` hand-offs have been written.
+    void waitFor(std::uint64_t ticket) {
+        std::unique_lock lock{mutex_};
+        drained_.wait(lock, [&] { return written_ >= ticket; });
+    }
+
+    std::uint64_t submitted() {
+        std::lock_guard lock{mutex_};
+        return submitted_;
+    }
+
+private:
+    void loop() {
+        std::vector<std::pair<Channel, std::string>> batch;
+        std::unique_lock lock{mutex_};
+        while (true) {
+            if (!wake_.wait_for(lock, kHandOffInterval, [&] { return stopping_ || !queue_.empty(); })) {
+                lock.unlock();
+                collectAll(); // submits, so never under mutex_
+                lock.lock();
+                continue;
+            }
+            if (queue_.empty() && stopping_) return;
+
+            batch.swap(queue_);
+            const std::uint64_t upTo = submitted_;
+            lock.unlock();
+            bool wroteOut = false;
+            bool wroteErr = false;
+            for (auto& [channel, text] : batch) {
+                std::fwrite(text.data(), 1, text.size(), channel == Out ? stdout : stderr);
+                (channel == Out ? wroteOut : wroteErr) = true;
+            }
+            if (wroteOut) std::fflush(stdout);
+            if (wroteErr) std::fflush(stderr);
+            batch.clear();
+            lock.lock();
+
+            written_ = upTo;
+            drained_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::vector<std::pair<Channel, std::string>> queue_;
+    std::uint64_t submitted_{0};
+    std::uint64_t written_{0};
+    bool stopping_{false};
+    std::thread thread_;
+};
+
+Flusher& flusher() {
+    registry(); // constructed first, so it outlives the flusher thread
+    static Flusher instance;
+    return instance;
+}
+
+// Per-thread formatting state. Constructing it touches flusher() first, so
+// the flusher outlives every thread's buffer. The owning thread and
+// collectors share `pending` under `mutex`, which is uncontended except
+// while a collection runs. Lock order: registry, buffer, flusher.
+struct ThreadBuffer {
+    ThreadBuffer() {
+        flusher();
+        std::lock_guard lock{registry().mutex};
+        registry().buffers.insert(this);
+    }
+
+    ~ThreadBuffer() {
+        std::lock_guard registered{registry().mutex};
+        registry().buffers.erase(this);
+        std::lock_guard lock{mutex};
+        handOff();
+    }
+
+    // Passes both pending buffers to the flusher, leaving fresh ones behind.
+    // Call with mutex held.
+    void handOff() {
+        for (int c = 0; c < 2; ++c) {
+            if (!pending[c].empty()) {
+                std::string text;
+                text.reserve(kHandOffBytes * 2);
+                text.swap(pending[c]);
+                flusher().submit(static_cast<Channel>(c), std::move(text));
+            }
+        }
+    }
+
+    std::ostringstream line; // owner thread only
+    std::mutex mutex;
+    std::string pending[2];
+};
+
+void collectAll() {
+    std::lock_guard registered{registry().mutex};
+    for (ThreadBuffer* buffer : registry().buffers) {
+        std::lock_guard lock{buffer->mutex};
+        buffer->handOff();
+    }
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+} // namespace
+
+void setLevel(Level l) { gLevel.store(static_cast<int>(l), std::memory_order_relaxed); }
+
+Level level() { return static_cast<Level>(gLevel.load(std::memory_order_relaxed)); }
+
+Level parseLevel(const std::string& name) {
+    if (name == "trace") return Level::Trace;
+    if (name == "debug") return Level::Debug;
+    if (name == "info") return Level::Info;
+    if (name == "warn") return Level::Warn;
+    if (name == "error") return Level::Error;
+    if (name == "off") return Level::Off;
+    throw std::invalid_argument("Unknown log level: " + name);
+}
+
+void flush() {
+    threadBuffer(); // registers the caller, so collectAll() covers it too
+    collectAll();
+    flusher().waitFor(flusher().submitted());
+}
+
+Line::Line(Level level) : level_{level}, stream_{threadBuffer().line} {
+    stream_.seekp(0);
+}
+
+Line::~Line() {
+    ThreadBuffer& buffer = threadBuffer();
+    const auto length = static_cast<std::size_t>(stream_.tellp());
+    const Channel channel = level_ >= Level::Warn ? Err : Out;
+    std::lock_guard lock{buffer.mutex};
+    std::string& pending = buffer.pending[channel];
+    pending.append(stream_.view().substr(0, length));
+    pending += '\n';
+    // Warnings and errors go out promptly; everything else in bulk.
+    if (channel == Err || pending.size() >= kHandOffBytes) {
+        buffer.handOff();
+    }
+}
+
+} // namespace logging
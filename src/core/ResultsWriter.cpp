@@ -0,0 +1,228 @@
+#include "core/ResultsWriter.h"
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace results {
+
+namespace {
+
+const char* sideName(Side side) { return side == Side::Long ? "long" : "short"; }
+
+nlohmann::json summaryJson(const AccountSummary& s) {
+    return {
+        {"initialBalance", s.initialBalance},
+        {"finalBalance", s.finalBalance},
+        {"netPnl", s.netPnl},
+        {"grossPnl", s.grossPnl},
+        {"totalFees", s.totalFees},
+        {"totalFunding", s.totalFunding},
+        {"totalTrades", s.totalTrades},
+        {"winRate", s.winRate},
+        {"tradeSharpe", s.sharpeRatio},
+        {"longTrades", s.longTrades},
+        {"netPnlLong", s.netPnlLong},
+        {"shortTrades", s.shortTrades},
+        {"netPnlShort", s.netPnlShort},
+    };
+}
+
+nlohmann::json riskJson(const metrics::RiskMetrics& r) {
+    return {
+        {"bars", r.bars},
+        {"finalEquity", r.finalEquity},
+        {"totalReturn", r.totalReturn},
+        {"annualReturn", r.annualReturn},
+        {"volatility", r.volatility},
+        {"maxDrawdown", r.maxDrawdown},
+        {"sharpe", r.sharpe},
+        {"sortino", r.sortino},
+        {"calmar", r.calmar},
+        {"exposure", r.exposure},
+        {"turnover", r.turnover},
+    };
+}
+
+// Appends values in their shortest round-trip form, without locale or stream state.
+template <typename T>
+void append(std::string& out, T value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+constexpr const char* kSummaryColumns =
+    "net_pnl,total_trades,win_rate,total_fees,total_funding,final_equity,annual_return,"
+    "max_drawdown,sharpe,sortino,calmar,exposure,turnover";
+
+void appendSummaryRow(std::string& out, const AccountSummary& s) {
+    const double values[] = {s.netPnl, static_cast<double>(s.totalTrades), s.winRate, s.totalFees,
+                             s.totalFunding, s.risk.finalEquity, s.risk.annualReturn, s.risk.maxDrawdown,
+                             s.risk.sharpe, s.risk.sortino, s.risk.calmar, s.risk.exposure, s.risk.turnover};
+    for (std::size_t i = 0; i < std::size(values); ++i) {
+        if (i > 0) out += ',';
+        append(out, values[i]);
+    }
+}
+
+} // namespace
+
+std::string toJson(const Account& account, const RunInfo& info) {
+    const auto summary = account.summarize();
+    const auto& trades = account.trades();
+
+    nlohmann::json side = nlohmann::json::array(), entryTs = nlohmann::json::array(),
+                   entryPx = nlohmann::json::array(), exitTs = nlohmann::json::array(),
+                   exitPx = nlohmann::json::array(), size = nlohmann::json::array(),
+                   pnl = nlohmann::json::array(), fee = nlohmann::json::array(),
+                   funding = nlohmann::json::array();
+    for (const auto& t : trades) {
+        side.push_back(sideName(t.side));
+        entryTs.push_back(t.entryTimestamp);
+        entryPx.push_back(t.entryPrice);
+        exitTs.push_back(t.exitTimestamp);
+        exitPx.push_back(t.exitPrice);
+        size.push_back(t.sizeAmount);
+        pnl.push_back(t.pnl);
+        fee.push_back(t.fee);
+        funding.push_back(t.funding);
+    }
+
+    nlohmann::json doc = {
+        {"label", info.label},
+        {"parameters", info.parameters},
+        {"summary", summaryJson(summary)},
+        {"risk", riskJson(summary.risk)},
+        {"trades",
+         {{"side", std::move(side)},
+          {"entryTimestamp", std::move(entryTs)},
+          {"entryPrice", std::move(entryPx)},
+          {"exitTimestamp", std::move(exitTs)},
+          {"exitPrice", std::move(exitPx)},
+          {"size", std::move(size)},
+          {"pnl", std::move(pnl)},
+          {"fee", std::move(fee)},
+          {"funding", std::move(funding)}}},
+    };
+
+    const auto& points = account.equityPoints();
+    if (!points.empty()) {
+        nlohmann::json timestamp = nlohmann::json::array(), equity = nlohmann::json::array(),
+                       drawdown = nlohmann::json::array();
+        for (const auto& p : points) {
+            timestamp.push_back(p.timestamp);
+            equity.push_back(p.equity);
+            drawdown.push_back(p.drawdown);
+        }
+        doc["equity"] = {{"timestamp", std::move(timestamp)},
+                         {"equity", std::move(equity)},
+                         {"drawdown", std::move(drawdown)}};
+    }
+    return doc.dump();
+}
+
+std::string tradesCsv(const Account& account) {
+    const auto& trades = account.trades();
+    std::string out = "side,entry_timestamp,entry_price,exit_timestamp,exit_price,size,pnl,fee,funding\n";
+    out.reserve(out.size() + trades.size() * 128);
+    for (const auto& t : trades) {
+        out += sideName(t.side);
+        out += ',';
+        append(out, t.entryTimestamp);
+        out += ',';
+        append(out, t.entryPrice);
+        out += ',';
+        append(out, t.exitTimestamp);
+        out += ',';
+        append(out, t.exitPrice);
+        out += ',';
+        append(out, t.sizeAmount);
+        out += ',';
+        append(out, t.pnl);
+        out += ',';
+        append(out, t.fee);
+        out += ',';
+        append(out, t.funding);
+        out += '\n';
+    }
+    return out;
+}
+
+std::string equityCsv(const Account& account) {
+    const auto& points = account.equityPoints();
+    std::string out = "timestamp,equity,drawdown\n";
+    out.reserve(out.size() + points.size() * 48);
+    for (const auto& p : points) {
+        append(out, p.timestamp);
+        out += ',';
+        append(out, p.equity);
+        out += ',';
+        append(out, p.drawdown);
+        out += '\n';
+    }
+    return out;
+}
+
+std::string sweepJson(const std::vector<SweepRow>& rows) {
+    nlohmann::json doc = nlohmann::json::array();
+    for (const auto& row : rows) {
+        doc.push_back({{"parameters", row.parameters},
+                       {"summary", summaryJson(row.summary)},
+                       {"risk", riskJson(row.summary.risk)}});
+    }
+    return doc.dump();
+}
+
+std::string sweepCsv(const std::vector<SweepRow>& rows) {
+    std::string out;
+    if (!rows.empty()) {
+        for (const auto& [name, value] : rows.front().parameters) {
+            out += name;
+            out += ',';
+        }
+    }
+    out += kSummaryColumns;
+    out += '\n';
+    out.reserve(out.size() + rows.size() * 256);
+    for (const auto& row : rows) {
+        for (const auto& [name, value] : row.parameters) {
+            append(out, value);
+            out += ',';
+        }
+        appendSummaryRow(out, row.summary);
+        out += '\n';
+    }
+    return out;
+}
+
+void writeFile(const std::string& path, const std::string& contents) {
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open results file for writing: " + tmpPath);
+        }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write results file: " + tmpPath);
+        }
+    }
+    std::filesystem::rename(tmpPath, path);
+}
+
+void writeRun(const std::string& base, const Account& account, const RunInfo& info) {
+    writeFile(base + ".json", toJson(account, info));
+    writeFile(base + ".trades.csv", tradesCsv(account));
+    if (!account.equityPoints().empty()) {
+        writeFile(base + ".equity.csv", equityCsv(account));
+    }
+}
+
+void writeSweep(const std::string& base, const std::vector<SweepRow>& rows) {
+    writeFile(base + ".json", sweepJson(rows));
+    writeFile(base + ".csv", sweepCsv(rows));
+}
+
+} // namespace results
@@ -0,0 +1,171 @@
+#include "core/Topology.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace topology {
+
+namespace {
+
+thread_local std::size_t tCurrentNode = 0;
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+int parseCpu(std::string_view s, std::string_view list) {
+    int value = 0;
+    const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (s.empty() || ec != std::errc{} || end != s.data() + s.size() || value < 0) {
+        throw std::invalid_argument("Malformed CPU list: '" + std::string(list) + "'");
+    }
+    return value;
+}
+
+// CPUs the calling process may be scheduled on.
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        const int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < n; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+} // namespace
+
+std::vector<int> parseCpuList(std::string_view list) {
+    std::vector<int> cpus;
+    std::string_view rest = trim(list);
+    while (!rest.empty()) {
+        const std::size_t comma = rest.find(',');
+        const std::string_view item = trim(rest.substr(0, comma));
+        rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+
+        const std::size_t dash = item.find('-');
+        if (dash == std::string_view::npos) {
+            cpus.push_back(parseCpu(item, list));
+            continue;
+        }
+        const int first = parseCpu(item.substr(0, dash), list);
+        const int last = parseCpu(item.substr(dash + 1), list);
+        if (last < first) {
+            throw std::invalid_argument("Malformed CPU list: '" + std::string(list) + "'");
+        }
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+Topology::Topology(std::vector<Node> nodes) : nodes_{std::move(nodes)} {
+    if (nodes_.empty()) {
+        throw std::invalid_argument("Topology needs at least one node");
+    }
+    for (const auto& node : nodes_) {
+        if (node.cpus.empty()) {
+            throw std::invalid_argument("Topology node " + std::to_string(node.id) + " has no CPUs");
+        }
+    }
+}
+
+Topology Topology::fromSysfs(const std::string& sysfsRoot, const std::vector<int>& allowed) {
+    namespace fs = std::filesystem;
+    std::vector<Node> nodes;
+    std::error_code ec;
+    for (fs::directory_iterator it{sysfsRoot, ec}, end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            continue;
+        }
+        std::ifstream file{it->path() / "cpulist"};
+        std::string list;
+        if (!file || !std::getline(file, list)) continue;
+
+        Node node;
+        node.id = std::stoi(name.substr(4));
+        for (int cpu : parseCpuList(list)) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        if (!node.cpus.empty()) nodes.push_back(std::move(node));
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+
+    if (nodes.empty()) {
+        Node all;
+        all.cpus = allowed;
+        std::sort(all.cpus.begin(), all.cpus.end());
+        nodes.push_back(std::move(all));
+    }
+    return Topology{std::move(nodes)};
+}
+
+Topology Topology::detect() {
+    return fromSysfs("/sys/devices/system/node", allowedCpus());
+}
+
+const Topology& Topology::system() {
+    static const Topology instance = detect();
+    return instance;
+}
+
+std::size_t Topology::cpuCount() const {
+    std::size_t n = 0;
+    for (const auto& node : nodes_) n += node.cpus.size();
+    return n;
+}
+
+Placement Topology::place(std::size_t index) const {
+    // Deal over the nodes first; a node that runs out of CPUs is skipped
+    // until every CPU has been used once, then the cycle repeats.
+    const std::size_t total = cpuCount();
+    std::size_t slot = index % total;
+    for (std::size_t round = 0;; ++round) {
+        for (std::size_t n = 0; n < nodes_.size(); ++n) {
+            if (round >= nodes_[n].cpus.size()) continue;
+            if (slot == 0) return {nodes_[n].cpus[round], n};
+            --slot;
+        }
+    }
+}
+
+bool pinCurrentThread(const Placement& placement) {
+    tCurrentNode = placement.node;
+#ifdef __linux__
+    if (placement.cpu < 0 || placement.cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(placement.cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+std::size_t currentNode() { return tCurrentNode; }
+
+} // namespace topology
@@ -1,10 +1,42 @@
 #include "data/Aggregator.h"
+#include <algorithm>
 #include <stdexcept>
 
-std::vector<Bar> Aggregator::aggregate(const std::vector<Bar>& raw) const {
+Aggregator::Aggregator(std::size_t resolutionMinutes) : resolution_{resolutionMinutes} {
     if (resolution_ == 0) {
         throw std::invalid_argument("Resolution cannot be zero.");
     }
+}
+
+bool Aggregator::step(State& state, const Bar& bar, long resolutionMillis, Bar& completed) {
+    bool emitted = false;
+    Bar& currentAggBar = state.current;
+
+    if (bar.timestamp >= state.nextTimestampBoundary) {
+        if (currentAggBar.timestamp != 0) {
+            completed = currentAggBar;
+            emitted = true;
+        }
+
+        // Start new aggregate bar
+        currentAggBar = bar;
+        currentAggBar.volume = 0; // Reset volume to sum up constituent volumes
+        currentAggBar.num_trades = 0; // Reset num_trades to sum up constituent trades
+        long barTimeBucket = bar.timestamp / resolutionMillis;
+        currentAggBar.timestamp = barTimeBucket * resolutionMillis;
+        state.nextTimestampBoundary = currentAggBar.timestamp + resolutionMillis;
+    }
+
+    // Update current aggregate bar
+    currentAggBar.high = std::max(currentAggBar.high, bar.high);
+    currentAggBar.low = std::min(currentAggBar.low, bar.low);
+    currentAggBar.close = bar.close;
+    currentAggBar.volume += bar.volume;
+    currentAggBar.num_trades += bar.num_trades;
+    return emitted;
+}
+
+std::vector<Bar> Aggregator::aggregate(const std::vector<Bar>& raw) const {
     if (raw.empty()) {
         return {};
     }
@@ -12,36 +44,143 @@ std::vector<Bar> Aggregator::aggregate(const std::vector<Bar>& raw) const {
     std::vector<Bar> aggregated;
     const long resolutionMillis = resolution_ * 60 * 1000;
     
-    Bar currentAggBar;
-    long nextTimestampBoundary = 0;
-
+    State state;
+    Bar completed;
     for (const auto& bar : raw) {
-        if (bar.timestamp >= nextTimestampBoundary) {
-            if (currentAggBar.timestamp != 0) {
-                aggregated.push_back(currentAggBar);
-            }
-
-            // Start new aggregate bar
-            currentAggBar = bar;
-            currentAggBar.volume = 0; // Reset volume to sum up constituent volumes
-            currentAggBar.num_trades = 0; // Reset num_trades to sum up constituent trades
-            long barTimeBucket = bar.timestamp / resolutionMillis;
-            currentAggBar.timestamp = barTimeBucket * resolutionMillis;
-            nextTimestampBoundary = currentAggBar.timestamp + resolutionMillis;
+        if (step(state, bar, resolutionMillis, completed)) {
+            aggregated.push_back(completed);
         }
-
-        // Update current aggregate bar
-        currentAggBar.high = std::max(currentAggBar.high, bar.high);
-        currentAggBar.low = std::min(currentAggBar.low, bar.low);
-        currentAggBar.close = bar.close;
-        currentAggBar.volume += bar.volume;
-        currentAggBar.num_trades += bar.num_trades;
     }
 
     // Add the last aggregated bar
-    if (currentAggBar.timestamp != 0) {
-        aggregated.push_back(currentAggBar);
+    if (state.current.timestamp != 0) {
+        aggregated.push_back(state.current);
     }
 
     return aggregated;
-} 
\ No newline at end of file
+}
+
+BarSeries Aggregator::aggregate(const BarSeries& raw) const {
+    const long resolutionMillis = static_cast<long>(resolution_ * 60 * 1000);
+    const auto ts = raw.timestamps();
+    const auto open = raw.opens();
+    const auto high = raw.highs();
+    const auto low = raw.lows();
+    const auto close = raw.closes();
+    const auto volume = raw.volumes();
+    const auto trades = raw.numTrades();
+    const std::size_t n = raw.size();
+
+    BarSeries aggregated;
+    aggregated.reserve(n / resolution_ + 1);
+    std::size_t begin = 0;
+    while (begin < n) {
+        // Same bucketing rule as step(): a bucket runs until the first bar at or
+        // past its end boundary.
+        const long bucket = ts[begin] / resolutionMillis * resolutionMillis;
+        const long boundary = bucket + resolutionMillis;
+        std::size_t end = begin + 1;
+        while (end < n && ts[end] < boundary) {
+            ++end;
+        }
+
+        Bar bar;
+        bar.timestamp = bucket;
+        bar.open = open[begin];
+        bar.high = *std::max_element(high.begin() + static_cast<std::ptrdiff_t>(begin),
+                                     high.begin() + static_cast<std::ptrdiff_t>(end));
+        bar.low = *std::min_element(low.begin() + static_cast<std::ptrdiff_t>(begin),
+                                    low.begin() + static_cast<std::ptrdiff_t>(end));
+        bar.close = close[end - 1];
+        for (std::size_t i = begin; i < end; ++i) {
+            bar.volume += volume[i];
+            bar.num_trades += trades[i];
+        }
+        aggregated.push_back(bar);
+        begin = end;
+    }
+    return aggregated;
+}
+
+bool Aggregator::push(const Bar& bar, Bar& completed) {
+    return step(state_, bar, static_cast<long>(resolution_ * 60 * 1000), completed);
+}
+
+bool Aggregator::flush(Bar& completed) {
+    if (state_.current.timestamp == 0) {
+        return false;
+    }
+    completed = state_.current;
+    state_ = State{};
+    return true;
+}
+
+AggregatedPriceSource::AggregatedPriceSource(std::shared_ptr<PriceSource> upstream,
+                                             std::size_t resolutionMinutes,
+                                             std::size_t batchSize)
+    : upstream_{std::move(upstream)}, aggregator_{resolutionMinutes}, input_(std::max<std::size_t>(1, batchSize)) {}
+
+std::vector<Bar> AggregatedPriceSource::fetch() {
+    std::vector<Bar> bars;
+    std::vector<Bar> batch(input_.size());
+    while (std::size_t n = next_batch(batch)) {
+        bars.insert(bars.end(), batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    return bars;
+}
+
+std::size_t AggregatedPriceSource::next_batch(std::span<Bar> out) {
+    std::size_t n = 0;
+    while (n < out.size()) {
+        if (inputPos_ == inputSize_) {
+            if (exhausted_) {
+                break;
+            }
+            inputSize_ = upstream_->next_batch(input_);
+            inputPos_ = 0;
+            if (inputSize_ == 0) {
+                exhausted_ = true;
+                if (aggregator_.flush(out[n])) {
+                    ++n;
+                }
+                break;
+            }
+        }
+        if (aggregator_.push(input_[inputPos_++], out[n])) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+MultiResolutionAggregator::MultiResolutionAggregator(std::vector<std::size_t> resolutionsMinutes, Callback onBar)
+    : resolutions_{std::move(resolutionsMinutes)}, onBar_{std::move(onBar)} {
+    aggregators_.reserve(resolutions_.size());
+    for (std::size_t resolution : resolutions_) {
+        aggregators_.emplace_back(resolution);
+    }
+}
+
+void MultiResolutionAggregator::push(const Bar& bar) {
+    Bar completed;
+    for (std::size_t i = 0; i < aggregators_.size(); ++i) {
+        if (aggregators_[i].push(bar, completed)) {
+            onBar_(resolutions_[i], completed);
+        }
+    }
+}
+
+void MultiResolutionAggregator::push(std::span<const Bar> bars) {
+    for (const auto& bar : bars) {
+        push(bar);
+    }
+}
+
+void MultiResolutionAggregator::flush() {
+    Bar completed;
+    for (std::size_t i = 0; i < aggregators_.size(); ++i) {
+        if (aggregators_[i].flush(completed)) {
+            onBar_(resolutions_[i], completed);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#include "data/BarFile.h"
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::endian::native == std::endian::little, "bar files are stored little-endian");
+static_assert(sizeof(double) == sizeof(std::uint64_t), "bar file columns are 8 bytes wide");
+
+namespace barfile {
+
+std::uint64_t checksum(const void* payload, std::uint64_t sizeBytes, std::uint64_t seed) {
+    constexpr std::uint64_t kPrime = 0x100000001b3ULL;
+
+    const auto* bytes = static_cast<const unsigned char*>(payload);
+    std::uint64_t hash = seed;
+    std::uint64_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= sizeBytes; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * kPrime;
+    }
+    for (; i < sizeBytes; ++i) {
+        hash = (hash ^ bytes[i]) * kPrime;
+    }
+    return hash;
+}
+
+void validateHeader(const Header& header, std::uint64_t actualFileSize, const std::string& path) {
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a bar file (bad magic): " + path);
+    }
+    if (header.version != kVersion) {
+        throw std::runtime_error("Unsupported bar file version " + std::to_string(header.version) + ": " + path);
+    }
+    if (header.columnCount != kColumnCount) {
+        throw std::runtime_error("Unexpected column count in bar file: " + path);
+    }
+    if (actualFileSize != fileSize(header.count)) {
+        throw std::runtime_error("Truncated or oversized bar file: " + path);
+    }
+}
+
+namespace {
+
+// The series columns in file order, as raw byte ranges.
+template <typename Series>
+auto columnBytes(Series& series) {
+    using Byte = std::conditional_t<std::is_const_v<Series>, const char, char>;
+    auto bytes = [](auto span) {
+        return std::span<Byte>{reinterpret_cast<Byte*>(span.data()), span.size_bytes()};
+    };
+    return std::array<std::span<Byte>, kColumnCount>{
+        bytes(series.timestamps()), bytes(series.opens()), bytes(series.highs()), bytes(series.lows()),
+        bytes(series.closes()), bytes(series.volumes()), bytes(series.numTrades())};
+}
+
+} // namespace
+
+void write(const std::string& path, const std::vector<Bar>& bars) {
+    write(path, BarSeries::fromBars(bars));
+}
+
+void write(const std::string& path, const BarSeries& series) {
+    // The file layout is the series layout, so each column is written as is.
+    const auto columns = columnBytes(series);
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.count = series.size();
+    header.columnCount = kColumnCount;
+    header.checksum = kChecksumSeed;
+    for (const auto& column : columns) {
+        header.checksum = checksum(column.data(), column.size(), header.checksum);
+    }
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open bar file for writing: " + tmpPath);
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& column : columns) {
+            file.write(column.data(), static_cast<std::streamsize>(column.size()));
+        }
+        if (!file) {
+            throw std::runtime_error("Failed to write bar file: " + tmpPath);
+        }
+    }
+    std::filesystem::rename(tmpPath, path);
+}
+
+std::vector<Bar> read(const std::string& path) {
+    return readSeries(path).toBars();
+}
+
+BarSeries readSeries(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open bar file: " + path);
+    }
+
+    std::error_code ec;
+    const std::uint64_t actualSize = std::filesystem::file_size(path, ec);
+    if (ec || actualSize < sizeof(Header)) {
+        throw std::runtime_error("Truncated bar file: " + path);
+    }
+
+    Header header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    validateHeader(header, actualSize, path);
+
+    BarSeries series(header.count);
+    std::uint64_t hash = kChecksumSeed;
+    for (const auto& column : columnBytes(series)) {
+        file.read(column.data(), static_cast<std::streamsize>(column.size()));
+        hash = checksum(column.data(), column.size(), hash);
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to read bar file: " + path);
+    }
+    if (hash != header.checksum) {
+        throw std::runtime_error("Bar file checksum mismatch: " + path);
+    }
+    return series;
+}
+
+} // namespace barfile
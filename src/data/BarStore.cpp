@@ -0,0 +1,107 @@
+#include "data/BarStore.h"
+#include "data/BarFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+// "Crypto.BTC/USD" -> "Crypto_BTC_USD", as for the legacy cache file names.
+std::string sanitize(std::string symbol) {
+    std::replace(symbol.begin(), symbol.end(), '/', '_');
+    std::replace(symbol.begin(), symbol.end(), '.', '_');
+    return symbol;
+}
+
+bool byTimestamp(const Bar& bar, std::int64_t ms) { return bar.timestamp < ms; }
+
+} // namespace
+
+BarStore::BarStore(std::string root, const std::string& symbol, std::string resolution)
+    : dir_{(std::filesystem::path{std::move(root)} / sanitize(symbol) / std::move(resolution)).string()} {}
+
+long BarStore::partitionStart(long seconds) {
+    const long day = seconds / kPartitionSeconds - (seconds % kPartitionSeconds < 0 ? 1 : 0);
+    return day * kPartitionSeconds;
+}
+
+std::vector<long> BarStore::partitionsFor(long from, long to) {
+    std::vector<long> starts;
+    for (long start = partitionStart(from); from <= to && start <= to; start += kPartitionSeconds) {
+        starts.push_back(start);
+    }
+    return starts;
+}
+
+std::string BarStore::partitionPath(long start) const {
+    using namespace std::chrono;
+    const year_month_day date{sys_days{days{start / kPartitionSeconds}}};
+    char name[32];
+    std::snprintf(name, sizeof(name), "%04d-%02u-%02u.bin", static_cast<int>(date.year()),
+                  static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+    return (std::filesystem::path{dir_} / name).string();
+}
+
+bool BarStore::hasPartition(long start) const {
+    std::error_code ec;
+    return std::filesystem::is_regular_file(partitionPath(start), ec);
+}
+
+std::vector<std::pair<long, long>> BarStore::missingRanges(long from, long to) const {
+    std::vector<std::pair<long, long>> ranges;
+    for (long start : partitionsFor(from, to)) {
+        if (hasPartition(start)) continue;
+        const long end = start + kPartitionSeconds - 1;
+        if (!ranges.empty() && ranges.back().second + 1 == start) {
+            ranges.back().second = end;
+        } else {
+            ranges.emplace_back(start, end);
+        }
+    }
+    return ranges;
+}
+
+std::size_t BarStore::store(const std::vector<Bar>& bars, long from, long to, long now) const {
+    std::size_t written = 0;
+    for (long start : partitionsFor(from, to)) {
+        const long end = start + kPartitionSeconds; // exclusive
+        if (start < from || end - 1 > to || end + kSettleSeconds > now) continue;
+
+        if (written == 0) {
+            std::filesystem::create_directories(dir_);
+        }
+        const std::int64_t startMs = static_cast<std::int64_t>(start) * 1000;
+        const std::int64_t endMs = static_cast<std::int64_t>(end) * 1000;
+        const auto first = std::lower_bound(bars.begin(), bars.end(), startMs, byTimestamp);
+        const auto last = std::lower_bound(first, bars.end(), endMs, byTimestamp);
+        barfile::write(partitionPath(start), std::vector<Bar>(first, last));
+        ++written;
+    }
+    return written;
+}
+
+std::vector<Bar> BarStore::load(long from, long to, std::vector<long>* unreadable) const {
+    const std::int64_t fromMs = static_cast<std::int64_t>(from) * 1000;
+    const std::int64_t toMs = static_cast<std::int64_t>(to) * 1000;
+
+    std::vector<Bar> bars;
+    for (long start : partitionsFor(from, to)) {
+        if (!hasPartition(start)) continue;
+        std::vector<Bar> day;
+        try {
+            day = barfile::read(partitionPath(start));
+        } catch (const std::exception&) {
+            if (!unreadable) throw;
+            std::error_code ec;
+            std::filesystem::remove(partitionPath(start), ec);
+            unreadable->push_back(start);
+            continue;
+        }
+        const auto first = std::lower_bound(day.begin(), day.end(), fromMs, byTimestamp);
+        const auto last = std::lower_bound(first, day.end(), toMs + 1, byTimestamp);
+        bars.insert(bars.end(), first, last);
+    }
+    return bars;
+}
@@ -1,8 +1,8 @@
 #include "data/BinancePriceSource.h"
+#include "core/Log.h"
 #include "nlohmann/json.hpp"
 #include <algorithm>
 #include <cpr/cpr.h>
-#include <iostream>
 #include <stdexcept>
 #include <thread>
 #include <future>
@@ -22,14 +22,29 @@ const std::map<int, long> BinancePriceSource::RESOLUTION_LIMITS = {
 };
 const long ONE_YEAR_SECONDS = 365 * 24 * 60 * 60;
 
-BinancePriceSource::BinancePriceSource(std::string symbol, std::string resolution, long from, long to)
+// Weight of a klines request with 1000 < limit <= 1500.
+constexpr double KLINES_WEIGHT = 10;
+
+// Futures API: 2400 request weight per minute per IP. The server reports the
+// weight used so far in the current minute with every response.
+HttpClient::Config BinancePriceSource::httpConfig() {
+    HttpClient::Config config;
+    config.capacity = 2400;
+    config.window = std::chrono::minutes{1};
+    config.usedWeightHeader = "X-MBX-USED-WEIGHT-1M";
+    return config;
+}
+
+BinancePriceSource::BinancePriceSource(std::string symbol, std::string resolution, long from, long to,
+                                       std::string baseUrl)
     : symbol_{std::move(symbol)},
       resolution_{std::move(resolution)},
       from_{from},
-      to_{to} {}
+      to_{to},
+      baseUrl_{std::move(baseUrl)},
+      http_{HttpClient::shared(baseUrl_, httpConfig())} {}
 
-std::vector<Bar> BinancePriceSource::fetch() {
-    long totalDuration = to_ - from_;
+std::vector<std::pair<long, long>> BinancePriceSource::planSegments() const {
     int resolutionInt = 0;
     try {
         resolutionInt = std::stoi(resolution_);
@@ -42,42 +57,43 @@ std::vector<Bar> BinancePriceSource::fetch() {
         resolutionLimit = RESOLUTION_LIMITS.at(resolutionInt);
     }
 
+    std::vector<std::pair<long, long>> segments;
+    long currentFrom = from_;
+    while (currentFrom < to_) {
+        long segmentTo = std::min(currentFrom + resolutionLimit, to_);
+        segments.emplace_back(currentFrom, segmentTo);
+        currentFrom = segmentTo;
+    }
+    return segments;
+}
+
+std::vector<Bar> BinancePriceSource::fetch() {
+    const auto segments = planSegments();
+
     std::vector<Bar> allBars;
 
-    if (totalDuration <= resolutionLimit) {
+    if (segments.size() <= 1) {
         // Fetch in a single request
-        std::cout << "Binance: Total duration within limit. Fetching in a single request." << std::endl;
-        allBars = fetchSegmentWithRetry(from_, to_, 0);
+        LOG_INFO << "Binance: Total duration within limit. Fetching in a single request.";
+        allBars = fetchSegment(from_, to_);
     } else {
         // Fetch in segments in parallel
-        std::cout << "Binance: Total duration exceeds limit. Fetching in parallel segments." << std::endl;
+        LOG_INFO << "Binance: Total duration exceeds limit. Fetching in parallel segments.";
         
-        // Calculate number of segments for rate limit warning
-        long numSegments = (totalDuration + resolutionLimit - 1) / resolutionLimit; // Ceiling division
-        if (numSegments > 10) {
-            std::cout << "Binance: Warning - Large dataset (" << numSegments 
-                      << " segments) may approach rate limits. Consider smaller time ranges." << std::endl;
-        }
-        
-        // Cap concurrency to avoid overwhelming the API endpoint (Binance rate limit: 240 req/min)
-        const size_t max_threads = 2;  // Reduced from 8 to avoid IP bans
+        // The shared rate limiter paces requests, so the pool only bounds open connections.
+        const size_t max_threads = 8;
         const size_t num_threads = (std::min)(max_threads, static_cast<size_t>(std::thread::hardware_concurrency()));
         ThreadPool pool(num_threads);
         
         std::vector<std::future<std::vector<Bar>>> futures;
 
-        long currentFrom = from_;
-        while (currentFrom < to_) {
-            long segmentTo = std::min(currentFrom + resolutionLimit, to_);
-            
-            std::cout << "Binance: Queuing segment from " << currentFrom << " to " << segmentTo 
-                      << " (limit=1500, 500ms delay)" << std::endl;
+        for (const auto& [segmentFrom, segmentTo] : segments) {
+            LOG_DEBUG << "Binance: Queuing segment from " << segmentFrom << " to " << segmentTo
+                      << " (limit=1500)";
             
             futures.push_back(
-                pool.enqueue(&BinancePriceSource::fetchSegmentWithRetry, this, currentFrom, segmentTo, 0)
+                pool.enqueue(&BinancePriceSource::fetchSegment, this, segmentFrom, segmentTo)
             );
-            
-            currentFrom = segmentTo;
         }
 
         // Collect results from all futures
@@ -86,13 +102,13 @@ std::vector<Bar> BinancePriceSource::fetch() {
                 std::vector<Bar> segmentBars = futures[i].get();
                 allBars.insert(allBars.end(), segmentBars.begin(), segmentBars.end());
             } catch (const std::exception& e) {
-                std::cerr << "Binance: Segment " << i << " failed after all retry attempts: " << e.what() << ". Aborting." << std::endl;
+                LOG_ERROR << "Binance: Segment " << i << " failed after all retry attempts: " << e.what() << ". Aborting.";
                 throw; 
             }
         }
     }
     
-    std::cout << "Binance: Successfully fetched a total of " << allBars.size() << " bars." << std::endl;
+    LOG_INFO << "Binance: Successfully fetched a total of " << allBars.size() << " bars.";
 
     // Sort and deduplicate
     std::sort(allBars.begin(), allBars.end(), [](const Bar& a, const Bar& b){
@@ -107,15 +123,16 @@ std::vector<Bar> BinancePriceSource::fetch() {
     return allBars;
 }
 
-std::vector<Bar> BinancePriceSource::fetchSegment(long from, long to, bool addDelay) {
-    // Always add delay to respect Binance rate limits (240 req/min = ~250ms between requests)
-    // Using 500ms to be conservative and avoid IP bans
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    
-    if (addDelay) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+std::size_t BinancePriceSource::next_batch(std::span<Bar> out) {
+    if (!stream_) {
+        stream_ = std::make_unique<SegmentPrefetcher>(planSegments(), [this](long from, long to) {
+            return fetchSegment(from, to);
+        });
     }
+    return stream_->next_batch(out);
+}
 
+std::vector<Bar> BinancePriceSource::fetchSegment(long from, long to) {
     std::string binanceSymbol = convertSymbolToBinance(symbol_);
     std::string binanceInterval = convertResolutionToBinance(resolution_);
 
@@ -123,70 +140,23 @@ std::vector<Bar> BinancePriceSource::fetchSegment(long from, long to, bool addDe
     long fromMs = from * 1000;
     long toMs = to * 1000;
 
-    cpr::Response r = cpr::Get(cpr::Url{baseUrl_ + "/fapi/v1/klines"},
-                               cpr::Parameters{{"symbol", binanceSymbol},
-                                               {"interval", binanceInterval},
-                                               {"startTime", std::to_string(fromMs)},
-                                               {"endTime", std::to_string(toMs)},
-                                               {"limit", "1500"}});
-    
-    if (r.status_code != 200) {
-        std::string errorDetail = "HTTP " + std::to_string(r.status_code) + 
-                                " - URL: " + r.url.str() + 
-                                " - Error: " + r.error.message;
-        if (!r.text.empty()) {
-            errorDetail += " - Response: " + r.text;
-        }
-        throw std::runtime_error("Failed to fetch segment from Binance API: " + errorDetail);
+    cpr::Response r;
+    try {
+        r = http_->get("/fapi/v1/klines",
+                       cpr::Parameters{{"symbol", binanceSymbol},
+                                       {"interval", binanceInterval},
+                                       {"startTime", std::to_string(fromMs)},
+                                       {"endTime", std::to_string(toMs)},
+                                       {"limit", "1500"}},
+                       KLINES_WEIGHT);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Failed to fetch segment [" + std::to_string(from) + " to " +
+                                 std::to_string(to) + "] from Binance API: " + e.what());
     }
     
     return parseJsonResponse(r.text);
 }
 
-std::vector<Bar> BinancePriceSource::fetchSegmentWithRetry(long from, long to, int retryCount) {
-    try {
-        // Attempt to fetch the segment
-        return fetchSegment(from, to, false);
-    } catch (const std::exception& e) {
-        std::string errorMsg = e.what();
-        
-        // Log the error with details
-        std::cerr << "Binance: Fetch attempt " << (retryCount + 1) << " failed for segment [" 
-                  << from << " to " << to << "]: " << errorMsg << std::endl;
-        
-        // Check if we should retry
-        if (retryCount < MAX_RETRIES) {
-            // Calculate delay with exponential backoff
-            int delayMs = INITIAL_RETRY_DELAY_MS * (1 << retryCount); // 2^retryCount
-            if (delayMs > MAX_RETRY_DELAY_MS) {
-                delayMs = MAX_RETRY_DELAY_MS;
-            }
-            
-            // Special handling for IP bans (HTTP 418) - use maximum delay immediately
-            if (errorMsg.find("HTTP 418") != std::string::npos || 
-                errorMsg.find("banned until") != std::string::npos) {
-                delayMs = MAX_RETRY_DELAY_MS;
-                std::cout << "Binance: IP ban detected. Using maximum delay for recovery." << std::endl;
-            }
-            
-            std::cout << "Binance: Retrying in " << (delayMs / 1000) << " seconds (attempt " 
-                      << (retryCount + 2) << "/" << (MAX_RETRIES + 1) << ")..." << std::endl;
-            
-            // Wait before retrying
-            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
-            
-            // Recursive retry
-            return fetchSegmentWithRetry(from, to, retryCount + 1);
-        } else {
-            // Max retries exceeded
-            std::string finalError = "Binance: Max retries (" + std::to_string(MAX_RETRIES) + 
-                                   ") exceeded for segment [" + std::to_string(from) + " to " + 
-                                   std::to_string(to) + "]. Last error: " + errorMsg;
-            throw std::runtime_error(finalError);
-        }
-    }
-}
-
 std::vector<Bar> BinancePriceSource::parseJsonResponse(const std::string& jsonBody) {
     std::vector<Bar> bars;
     try {
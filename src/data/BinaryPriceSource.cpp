@@ -0,0 +1,8 @@
+#include "data/BinaryPriceSource.h"
+#include "data/BarFile.h"
+
+BinaryPriceSource::BinaryPriceSource(std::string path) : path_{std::move(path)} {}
+
+std::vector<Bar> BinaryPriceSource::fetch() {
+    return barfile::read(path_);
+}
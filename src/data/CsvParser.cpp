@@ -0,0 +1,126 @@
+#include "data/CsvParser.h"
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+namespace csv {
+
+namespace {
+
+[[noreturn]] void malformed(std::string_view line) {
+    throw std::runtime_error("Malformed CSV line: " + std::string(line));
+}
+
+// Parses one field starting at p, which must end at a ',' or at end. Leaves p
+// after the separator.
+template <typename T>
+T parseField(const char*& p, const char* end, std::string_view line) {
+    T value{};
+    auto [next, ec] = std::from_chars(p, end, value);
+    if (ec != std::errc{} || (next != end && *next != ',')) {
+        malformed(line);
+    }
+    p = (next == end) ? end : next + 1;
+    return value;
+}
+
+// Parses one line (without its '\n'). Returns false for blank lines.
+bool parseLine(const char* p, const char* lineEnd, Bar& bar) {
+    if (lineEnd > p && lineEnd[-1] == '\r') {
+        --lineEnd;
+    }
+    if (lineEnd == p) {
+        return false;
+    }
+
+    const std::string_view line{p, static_cast<std::size_t>(lineEnd - p)};
+    bar.timestamp = parseField<std::int64_t>(p, lineEnd, line);
+    bar.open = parseField<double>(p, lineEnd, line);
+    bar.high = parseField<double>(p, lineEnd, line);
+    bar.low = parseField<double>(p, lineEnd, line);
+    bar.close = parseField<double>(p, lineEnd, line);
+    bar.volume = parseField<double>(p, lineEnd, line);
+    // Handle num_trades field (optional for backward compatibility)
+    bar.num_trades = (p < lineEnd) ? parseField<std::int64_t>(p, lineEnd, line) : 0;
+    return true;
+}
+
+} // namespace
+
+std::string_view skipHeader(std::string_view text) {
+    const auto newline = text.find('\n');
+    return newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+}
+
+std::size_t estimateRows(std::string_view body) {
+    const auto newline = body.find('\n');
+    if (newline == std::string_view::npos) {
+        return body.empty() ? 0 : 1;
+    }
+    // Later rows are usually no shorter than the first; leave ~10% headroom.
+    const std::size_t lineLength = newline + 1;
+    return body.size() / lineLength + body.size() / lineLength / 10 + 1;
+}
+
+void parseBars(std::string_view body, std::vector<Bar>& out) {
+    const char* p = body.data();
+    const char* const bodyEnd = p + body.size();
+
+    while (p < bodyEnd) {
+        const char* lineEnd = std::char_traits<char>::find(p, bodyEnd - p, '\n');
+        const char* next = lineEnd ? lineEnd + 1 : bodyEnd;
+        Bar bar;
+        if (parseLine(p, lineEnd ? lineEnd : bodyEnd, bar)) {
+            out.push_back(bar);
+        }
+        p = next;
+    }
+}
+
+std::size_t parseLines(std::string_view text, std::span<Bar> out, bool atEof, std::size_t& consumed) {
+    const char* const begin = text.data();
+    const char* p = begin;
+    const char* const textEnd = begin + text.size();
+
+    std::size_t n = 0;
+    while (n < out.size() && p < textEnd) {
+        const char* lineEnd = std::char_traits<char>::find(p, textEnd - p, '\n');
+        if (!lineEnd && !atEof) {
+            break; // incomplete line: wait for more input
+        }
+        const char* next = lineEnd ? lineEnd + 1 : textEnd;
+        if (parseLine(p, lineEnd ? lineEnd : textEnd, out[n])) {
+            ++n;
+        }
+        p = next;
+    }
+    consumed = static_cast<std::size_t>(p - begin);
+    return n;
+}
+
+std::vector<std::string_view> splitChunks(std::string_view body, std::size_t maxChunks) {
+    std::vector<std::string_view> chunks;
+    if (body.empty()) {
+        return chunks;
+    }
+    if (maxChunks == 0) {
+        maxChunks = 1;
+    }
+
+    const std::size_t target = body.size() / maxChunks + 1;
+    std::size_t begin = 0;
+    while (begin < body.size()) {
+        std::size_t end = begin + target;
+        if (end >= body.size()) {
+            end = body.size();
+        } else {
+            const auto newline = body.find('\n', end);
+            end = (newline == std::string_view::npos) ? body.size() : newline + 1;
+        }
+        chunks.push_back(body.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+} // namespace csv
@@ -1,52 +1,141 @@
 #include "data/CsvPriceSource.h"
+#include "data/CsvParser.h"
+#include "engine/ThreadPool.h"
+#include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <future>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
-CsvPriceSource::CsvPriceSource(std::string csvPath) : path_{std::move(csvPath)} {}
+CsvPriceSource::CsvPriceSource(std::string csvPath, std::size_t threadCount)
+    : path_{std::move(csvPath)}, threadCount_{threadCount} {}
 
 std::vector<Bar> CsvPriceSource::fetch() {
-    std::ifstream file(path_);
+    std::ifstream file(path_, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open CSV file: " + path_);
     }
 
+    // Read the whole file with a single call and parse it in place.
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path_, ec);
+    if (ec) {
+        throw std::runtime_error("Could not determine size of CSV file: " + path_);
+    }
+    std::string text(size, '\0');
+    file.read(text.data(), static_cast<std::streamsize>(size));
+    text.resize(static_cast<std::size_t>(file.gcount()));
+
+    const std::string_view body = csv::skipHeader(text);
+    if (threadCount_ > 1 && body.size() >= kParallelThresholdBytes) {
+        return parseParallel(body);
+    }
+
     std::vector<Bar> bars;
-    std::string line;
-    // Skip header
-    if (!std::getline(file, line)) {
-        return bars; // empty file
-    }
-
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string cell;
-        Bar bar;
-        
-        // timestamp,open,high,low,close,volume,num_trades
-        std::getline(ss, cell, ',');
-        bar.timestamp = std::stoll(cell);
-        std::getline(ss, cell, ',');
-        bar.open = std::stod(cell);
-        std::getline(ss, cell, ',');
-        bar.high = std::stod(cell);
-        std::getline(ss, cell, ',');
-        bar.low = std::stod(cell);
-        std::getline(ss, cell, ',');
-        bar.close = std::stod(cell);
-        std::getline(ss, cell, ',');
-        bar.volume = std::stod(cell);
-        
-        // Handle num_trades field (optional for backward compatibility)
-        if (std::getline(ss, cell, ',')) {
-            bar.num_trades = std::stoll(cell);
+    bars.reserve(csv::estimateRows(body));
+    csv::parseBars(body, bars);
+    return bars;
+}
+
+std::vector<Bar> CsvPriceSource::parseParallel(std::string_view body) const {
+    const auto chunks = csv::splitChunks(body, threadCount_);
+
+    ThreadPool pool(std::min(threadCount_, chunks.size()));
+    std::vector<std::future<std::vector<Bar>>> futures;
+    futures.reserve(chunks.size());
+    for (const auto chunk : chunks) {
+        futures.push_back(pool.enqueue([chunk] {
+            std::vector<Bar> part;
+            part.reserve(csv::estimateRows(chunk));
+            csv::parseBars(chunk, part);
+            return part;
+        }));
+    }
+
+    std::vector<std::vector<Bar>> parts;
+    parts.reserve(futures.size());
+    std::size_t total = 0;
+    for (auto& future : futures) {
+        parts.push_back(future.get());
+        total += parts.back().size();
+    }
+
+    // Chunks are in file order, so concatenating them yields exactly what the
+    // serial parser produces (time order for the caches we write).
+    std::vector<Bar> bars;
+    bars.reserve(total);
+    for (const auto& part : parts) {
+        bars.insert(bars.end(), part.begin(), part.end());
+    }
+    return bars;
+}
+
+std::size_t CsvPriceSource::next_batch(std::span<Bar> out) {
+    if (!stream_.is_open()) {
+        stream_.open(path_, std::ios::binary);
+        if (!stream_.is_open()) {
+            throw std::runtime_error("Could not open CSV file: " + path_);
+        }
+        refill();
+    }
+
+    std::size_t written = 0;
+    while (written < out.size()) {
+        const std::string_view text{pending_.data() + pendingPos_, pending_.size() - pendingPos_};
+        if (!headerSkipped_) {
+            const auto newline = text.find('\n');
+            if (newline != std::string_view::npos) {
+                pendingPos_ += newline + 1;
+                headerSkipped_ = true;
+                continue;
+            }
+            if (eof_) {
+                break; // header only
+            }
         } else {
-            bar.num_trades = 0;  // Default for old CSV files
+            std::size_t consumed = 0;
+            written += csv::parseLines(text, out.subspan(written), eof_, consumed);
+            pendingPos_ += consumed;
+            if (written == out.size() || eof_) {
+                break;
+            }
         }
+        refill();
+    }
+    return written;
+}
 
-        bars.push_back(bar);
+void CsvPriceSource::refill() {
+    // Keep the unparsed tail (at most one partial line) and append the next block.
+    pending_.erase(0, pendingPos_);
+    pendingPos_ = 0;
+
+    const std::size_t keep = pending_.size();
+    pending_.resize(keep + kStreamBlockBytes);
+    stream_.read(pending_.data() + keep, static_cast<std::streamsize>(kStreamBlockBytes));
+    const auto got = static_cast<std::size_t>(stream_.gcount());
+    pending_.resize(keep + got);
+    if (got < kStreamBlockBytes) {
+        eof_ = true;
     }
+}
 
-    return bars;
-} 
\ No newline at end of file
+void CsvPriceSource::write(const std::string& csvPath, const std::vector<Bar>& bars) {
+    std::ofstream file(csvPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open CSV file for writing: " + csvPath);
+    }
+
+    file << "timestamp,open,high,low,close,volume,num_trades\n";
+    file << std::fixed; // Use fixed-point notation for doubles
+    for (const auto& bar : bars) {
+        file << bar.timestamp << ","
+             << bar.open << ","
+             << bar.high << ","
+             << bar.low << ","
+             << bar.close << ","
+             << bar.volume << ","
+             << bar.num_trades << "\n";
+    }
+}
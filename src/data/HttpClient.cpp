@@ -0,0 +1,116 @@
+#include "data/HttpClient.h"
+#include "core/Log.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Retry-After in seconds, if the response carries a numeric one.
+bool retryAfter(const cpr::Response& r, std::chrono::milliseconds& delay) {
+    const auto it = r.header.find("Retry-After");
+    if (it == r.header.end()) return false;
+    try {
+        delay = std::chrono::seconds{std::stol(it->second)};
+        return true;
+    } catch (const std::exception&) {
+        return false; // HTTP-date form; use the backoff instead
+    }
+}
+
+std::string describe(const cpr::Response& r) {
+    std::string detail = "HTTP " + std::to_string(r.status_code) + " - URL: " + r.url.str();
+    if (!r.error.message.empty()) detail += " - Error: " + r.error.message;
+    if (!r.text.empty()) detail += " - Response: " + r.text.substr(0, 512);
+    return detail;
+}
+
+} // namespace
+
+HttpClient::HttpClient(std::string baseUrl, const Config& config)
+    : baseUrl_{std::move(baseUrl)}, config_{config}, limiter_{config.capacity, config.window} {}
+
+std::shared_ptr<HttpClient> HttpClient::shared(const std::string& baseUrl, const Config& config) {
+    static std::mutex mutex;
+    static std::map<std::string, std::vector<std::shared_ptr<HttpClient>>> clients;
+    std::lock_guard lock{mutex};
+    auto& forHost = clients[baseUrl];
+    for (const auto& client : forHost) {
+        if (client->config_ == config) return client;
+    }
+    return forHost.emplace_back(std::make_shared<HttpClient>(baseUrl, config));
+}
+
+std::unique_ptr<cpr::Session> HttpClient::takeSession() {
+    {
+        std::lock_guard lock{mutex_};
+        if (!idle_.empty()) {
+            auto session = std::move(idle_.back());
+            idle_.pop_back();
+            return session;
+        }
+    }
+    auto session = std::make_unique<cpr::Session>();
+    session->SetTimeout(cpr::Timeout{config_.timeout});
+    session->SetConnectTimeout(cpr::ConnectTimeout{std::chrono::milliseconds{10000}});
+    return session;
+}
+
+void HttpClient::returnSession(std::unique_ptr<cpr::Session> session) {
+    std::lock_guard lock{mutex_};
+    idle_.push_back(std::move(session));
+}
+
+cpr::Response HttpClient::get(const std::string& path, const cpr::Parameters& parameters, double weight) {
+    const cpr::Url url{baseUrl_ + path};
+    std::chrono::milliseconds backoff = config_.initialBackoff;
+    for (int attempt = 1;; ++attempt) {
+        limiter_.acquire(weight);
+
+        auto session = takeSession();
+        session->SetUrl(url);
+        session->SetParameters(parameters);
+        cpr::Response r = session->Get();
+        returnSession(std::move(session));
+
+        if (!config_.usedWeightHeader.empty()) {
+            const auto used = r.header.find(config_.usedWeightHeader);
+            if (used != r.header.end()) {
+                try {
+                    limiter_.observeUsed(std::stod(used->second));
+                } catch (const std::exception&) {
+                    // Ignore a malformed header; the local bucket still applies.
+                }
+            }
+        }
+        if (r.status_code == 200) {
+            return r;
+        }
+
+        const bool limited = r.status_code == 429 || r.status_code == 418;
+        const bool transient = r.status_code == 0 || r.status_code >= 500;
+        if (!limited && !transient) {
+            throw std::runtime_error(describe(r));
+        }
+        if (attempt >= config_.maxAttempts) {
+            throw std::runtime_error("Max attempts (" + std::to_string(config_.maxAttempts) +
+                                     ") exceeded. Last error: " + describe(r));
+        }
+
+        std::chrono::milliseconds delay = backoff;
+        if (limited) {
+            // Every request to this host waits out a 429/418, not just this one.
+            retryAfter(r, delay);
+            limiter_.pauseFor(delay);
+            LOG_WARN << baseUrl_ << ": HTTP " << r.status_code << (r.status_code == 418 ? " (IP ban)" : "")
+                     << ", pausing requests for " << delay.count() << " ms (attempt " << attempt << "/"
+                     << config_.maxAttempts << ")";
+        } else {
+            LOG_WARN << baseUrl_ << ": " << describe(r) << "; retrying in " << delay.count() << " ms (attempt "
+                     << attempt << "/" << config_.maxAttempts << ")";
+            std::this_thread::sleep_for(delay);
+        }
+        backoff = std::min(backoff * 2, config_.maxBackoff);
+    }
+}
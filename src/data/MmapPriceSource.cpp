@@ -0,0 +1,143 @@
+#include "data/MmapPriceSource.h"
+#include "data/BarFile.h"
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <filesystem>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::mutex registryMutex;
+std::map<std::string, std::weak_ptr<const MappedBarFile>> registry;
+
+std::uint64_t currentFileId(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return 0;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(st.st_ino);
+#endif
+}
+
+} // namespace
+
+std::shared_ptr<const MappedBarFile> MappedBarFile::open(const std::string& path) {
+    std::lock_guard lock{registryMutex};
+    auto& slot = registry[path];
+    if (auto existing = slot.lock()) {
+        // Reuse the mapping unless the file has since been replaced (new inode).
+        if (existing->fileId_ == currentFileId(path)) {
+            return existing;
+        }
+    }
+    std::shared_ptr<const MappedBarFile> file{new MappedBarFile(path)};
+    slot = file;
+    return file;
+}
+
+MappedBarFile::MappedBarFile(std::string path) : path_{std::move(path)} {
+#ifdef _WIN32
+    // No mmap here: fall back to a private heap copy with the same view semantics.
+    std::error_code ec;
+    size_ = std::filesystem::file_size(path_, ec);
+    if (ec) {
+        throw std::runtime_error("Could not open bar file: " + path_);
+    }
+    std::ifstream file(path_, std::ios::binary);
+    data_ = ::operator new(size_);
+    file.read(static_cast<char*>(data_), static_cast<std::streamsize>(size_));
+#else
+    const int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open bar file: " + path_);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not stat bar file: " + path_);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    fileId_ = static_cast<std::uint64_t>(st.st_ino);
+    if (size_ < sizeof(barfile::Header)) {
+        ::close(fd);
+        throw std::runtime_error("Truncated bar file: " + path_);
+    }
+
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps its own reference to the file
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Could not map bar file: " + path_);
+    }
+    data_ = mapped;
+    madvise(data_, size_, MADV_SEQUENTIAL);
+#endif
+
+    try {
+        barfile::Header header;
+        std::memcpy(&header, data_, sizeof(header));
+        barfile::validateHeader(header, size_, path_);
+
+        const auto* base = static_cast<const unsigned char*>(data_);
+        if (barfile::checksum(base + sizeof(header), size_ - sizeof(header)) != header.checksum) {
+            throw std::runtime_error("Bar file checksum mismatch: " + path_);
+        }
+
+        // Columns start on 8-byte boundaries of a page-aligned mapping.
+        const std::size_t n = header.count;
+        auto i64 = [&](barfile::Column c) {
+            return std::span<const std::int64_t>{
+                reinterpret_cast<const std::int64_t*>(base + barfile::columnOffset(n, c)), n};
+        };
+        auto f64 = [&](barfile::Column c) {
+            return std::span<const double>{reinterpret_cast<const double*>(base + barfile::columnOffset(n, c)), n};
+        };
+        view_.timestamp = i64(barfile::Column::Timestamp);
+        view_.open = f64(barfile::Column::Open);
+        view_.high = f64(barfile::Column::High);
+        view_.low = f64(barfile::Column::Low);
+        view_.close = f64(barfile::Column::Close);
+        view_.volume = f64(barfile::Column::Volume);
+        view_.num_trades = i64(barfile::Column::NumTrades);
+    } catch (...) {
+#ifdef _WIN32
+        ::operator delete(data_);
+#else
+        munmap(data_, size_);
+#endif
+        throw;
+    }
+}
+
+MappedBarFile::~MappedBarFile() {
+#ifdef _WIN32
+    ::operator delete(data_);
+#else
+    munmap(data_, size_);
+#endif
+}
+
+MmapPriceSource::MmapPriceSource(std::string path) : file_{MappedBarFile::open(path)} {}
+
+std::vector<Bar> MmapPriceSource::fetch() {
+    const auto& v = view();
+    std::vector<Bar> bars;
+    bars.reserve(v.size());
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        bars.push_back(v[i]);
+    }
+    return bars;
+}
@@ -1,14 +1,18 @@
 #include "data/PriceManager.h"
+#include "core/Log.h"
+#include "data/BarFile.h"
+#include "data/BarStore.h"
+#include "data/BinaryPriceSource.h"
 #include "data/CsvPriceSource.h"
 #include "data/PythPriceSource.h"
 #include "data/BinancePriceSource.h"
+#include "engine/ThreadPool.h"
 #include <algorithm>
-#include <fstream>
-#include <iostream>
+#include <cstdint>
+#include <filesystem>
 #include <stdexcept>
 #include <sys/stat.h>
 #include <system_error>
-#include <unordered_map>
 
 // Helper to check for file existence
 inline bool fileExists(const std::string& name) {
@@ -29,7 +33,7 @@ inline bool createDirectoryIfNotExists(const std::string& path) {
     #endif
     
     if (result == 0) {
-        std::cout << "Created directory: " << path << std::endl;
+        LOG_INFO << "Created directory: " << path;
         return true;
     }
     
@@ -40,146 +44,189 @@ inline bool createDirectoryIfNotExists(const std::string& path) {
     
     std::error_code ec;
     std::string errorMsg = std::system_category().message(errno);
-    std::cerr << "Failed to create directory " << path << ": " << errorMsg << std::endl;
+    LOG_ERROR << "Failed to create directory " << path << ": " << errorMsg;
     return false;
 }
 
-PriceManager::PriceManager(std::string symbol, std::string resolution, long from, long to)
+PriceManager::PriceManager(std::string symbol, std::string resolution, long from, long to,
+                           std::string cacheDir, Fetcher fetcher)
     : symbol_{std::move(symbol)},
       resolution_{std::move(resolution)},
       from_{from},
-      to_{to} {}
+      to_{to},
+      priceHistoryPath_{std::move(cacheDir)},
+      fetcher_{std::move(fetcher)} {}
 
 std::vector<Bar> PriceManager::loadData() {
+    std::string binPath = getBinaryPath();
+    if (fileExists(binPath)) {
+        try {
+            LOG_INFO << "Loading data from binary cache: " << binPath;
+            BinaryPriceSource binSource(binPath);
+            return binSource.fetch();
+        } catch (const std::exception& e) {
+            LOG_WARN << "Warning: Ignoring unreadable cache (" << e.what() << ")";
+        }
+    }
+
     std::string csvPath = getCsvPath();
     if (fileExists(csvPath)) {
-        std::cout << "Loading data from cached CSV: " << csvPath << std::endl;
+        LOG_INFO << "Loading data from cached CSV: " << csvPath;
         CsvPriceSource csvSource(csvPath);
-        return csvSource.fetch();
+        std::vector<Bar> bars = csvSource.fetch();
+        LOG_INFO << "Converting CSV cache to binary: " << binPath;
+        cacheData(bars);
+        return bars;
     }
-    
-    std::cout << "No local cache found. Fetching from Pyth and Binance APIs..." << std::endl;
-    
-    // Fetch OHLC data from Pyth
-    std::cout << "Fetching OHLC data from Pyth..." << std::endl;
-    PythPriceSource pythSource(symbol_, resolution_, from_, to_);
-    std::vector<Bar> pythBars = pythSource.fetch();
-    
-    // Fetch volume and trades data from Binance
-    std::cout << "Fetching volume and trades data from Binance..." << std::endl;
-    BinancePriceSource binanceSource(symbol_, resolution_, from_, to_);
-    std::vector<Bar> binanceBars = binanceSource.fetch();
-    
-    // Combine the data sources
-    std::cout << "Combining data from both sources..." << std::endl;
-    std::vector<Bar> combinedBars = combineData(pythBars, binanceBars);
-    
-    if (!combinedBars.empty()) {
-        std::cout << "Caching " << combinedBars.size() << " combined bars to " << csvPath << "..." << std::endl;
-        cacheDataToCsv(combinedBars);
+
+    return loadFromStore();
+}
+
+std::vector<Bar> PriceManager::loadFromStore() {
+    BarStore store{priceHistoryPath_, symbol_, resolution_};
+    const std::size_t partitions = BarStore::partitionsFor(from_, to_).size();
+    std::vector<Bar> fetched;
+
+    // A corrupt or truncated partition found while loading is deleted by the
+    // store, and the second pass fetches just those days. Days fetched in the
+    // first pass (including ones too recent to store) are not fetched again,
+    // so `fetched` never holds a day twice.
+    auto gaps = store.missingRanges(from_, to_);
+    for (int pass = 0;; ++pass) {
+        if (gaps.empty()) {
+            LOG_INFO << "Loading " << partitions << " day partition(s) from the bar store.";
+        }
+
+        // Gaps are whole days, so every fetched day can be stored as a complete partition.
+        for (const auto& [gapFrom, gapTo] : gaps) {
+            LOG_INFO << "Fetching missing days [" << gapFrom << ", " << gapTo << "] ("
+                     << (gapTo - gapFrom + 1) / BarStore::kPartitionSeconds << " of " << partitions
+                     << " partitions)...";
+            std::vector<Bar> bars = fetcher_ ? fetcher_(gapFrom, gapTo) : fetchRemote(gapFrom, gapTo);
+            try {
+                const std::size_t written = store.store(bars, gapFrom, gapTo);
+                LOG_INFO << "Cached " << bars.size() << " bars in " << written << " day partition(s).";
+            } catch (const std::exception& e) {
+                LOG_WARN << "Warning: Could not cache data: " << e.what();
+            }
+            fetched.insert(fetched.end(), bars.begin(), bars.end());
+        }
+
+        std::vector<long> unreadable;
+        std::vector<Bar> bars = store.load(from_, to_, &unreadable);
+        if (!unreadable.empty() && pass == 0) {
+            LOG_WARN << "Warning: Removed " << unreadable.size()
+                     << " unreadable day partition(s) from the bar store; fetching them again.";
+            gaps.clear();
+            for (long start : unreadable) { // ascending
+                const long end = start + BarStore::kPartitionSeconds - 1;
+                if (!gaps.empty() && gaps.back().second + 1 == start) {
+                    gaps.back().second = end;
+                } else {
+                    gaps.emplace_back(start, end);
+                }
+            }
+            continue;
+        }
+
+        // Stored days come back from disk; days that could not be stored (still
+        // in progress, a failed write, or unreadable again) come from what was
+        // just fetched.
+        for (const auto& [gapFrom, gapTo] : store.missingRanges(from_, to_)) {
+            const std::int64_t fromMs = static_cast<std::int64_t>(std::max(gapFrom, from_)) * 1000;
+            const std::int64_t toMs = static_cast<std::int64_t>(std::min(gapTo, to_)) * 1000;
+            for (const auto& bar : fetched) {
+                if (bar.timestamp >= fromMs && bar.timestamp <= toMs) bars.push_back(bar);
+            }
+        }
+        std::sort(bars.begin(), bars.end(), [](const Bar& a, const Bar& b) { return a.timestamp < b.timestamp; });
+        return bars;
     }
-    
-    return combinedBars;
 }
 
-std::string PriceManager::getCsvPath() const {
+std::vector<Bar> PriceManager::fetchRemote(long from, long to) const {
+    // The two APIs are independent, so a cold load costs the slower of the
+    // two downloads rather than their sum.
+    ThreadPool pool{2};
+    LOG_INFO << "Fetching OHLC data from Pyth and volume and trades data from Binance...";
+    auto pythBars = pool.enqueue([&] {
+        return PythPriceSource(symbol_, resolution_, from, to, endpoints_.pyth).fetch();
+    });
+    auto binanceBars = pool.enqueue([&] {
+        return BinancePriceSource(symbol_, resolution_, from, to, endpoints_.binance).fetch();
+    });
+
+    LOG_INFO << "Combining data from both sources...";
+    return combineData(pythBars.get(), binanceBars.get());
+}
+
+std::string PriceManager::getCacheBaseName() const {
     // Create a filesystem-friendly name, e.g., "Crypto.BTC/USD" -> "Crypto_BTC_USD"
     std::string sanitizedSymbol = symbol_;
     std::replace(sanitizedSymbol.begin(), sanitizedSymbol.end(), '/', '_');
     std::replace(sanitizedSymbol.begin(), sanitizedSymbol.end(), '.', '_');
     
-    // New format: ticker_resolution_startTimestamp_endTimestamp.csv
-    return priceHistoryPath_ + sanitizedSymbol + "_" + resolution_ + "_" + std::to_string(from_) + "_" + std::to_string(to_) + ".csv";
+    // Format: ticker_resolution_startTimestamp_endTimestamp
+    return (std::filesystem::path{priceHistoryPath_} / sanitizedSymbol).string() + "_" + resolution_ + "_" +
+           std::to_string(from_) + "_" + std::to_string(to_);
+}
+
+std::string PriceManager::getCsvPath() const {
+    return getCacheBaseName() + ".csv";
 }
 
-void PriceManager::cacheDataToCsv(const std::vector<Bar>& bars) const {
+std::string PriceManager::getBinaryPath() const {
+    return getCacheBaseName() + ".bin";
+}
+
+void PriceManager::cacheData(const std::vector<Bar>& bars) const {
     // Ensure the price_history directory exists
     if (!createDirectoryIfNotExists(priceHistoryPath_)) {
-        std::cerr << "Warning: Could not create price history directory. Data will not be cached." << std::endl;
+        LOG_WARN << "Warning: Could not create price history directory. Data will not be cached.";
         return;
     }
 
-    std::string csvPath = getCsvPath();
-    std::ofstream file(csvPath);
-    if (!file.is_open()) {
-        std::cerr << "Warning: Could not open file to cache data: " << csvPath << std::endl;
-        return;
+    try {
+        barfile::write(getBinaryPath(), bars);
+    } catch (const std::exception& e) {
+        LOG_WARN << "Warning: Could not cache data: " << e.what();
     }
+}
 
-    file << "timestamp,open,high,low,close,volume,num_trades\n";
-    file << std::fixed; // Use fixed-point notation for doubles
-    for (const auto& bar : bars) {
-        file << bar.timestamp << ","
-             << bar.open << ","
-             << bar.high << ","
-             << bar.low << ","
-             << bar.close << ","
-             << bar.volume << ","
-             << bar.num_trades << "\n";
-    }
+void PriceManager::exportCsv(const std::vector<Bar>& bars, const std::string& csvPath) {
+    CsvPriceSource::write(csvPath, bars);
 }
 
-std::vector<Bar> PriceManager::combineData(const std::vector<Bar>& pythBars, const std::vector<Bar>& binanceBars) const {
+std::vector<Bar> PriceManager::combineData(const std::vector<Bar>& pythBars, const std::vector<Bar>& binanceBars) {
     std::vector<Bar> combinedBars;
-    
-    // Create a hash map of Binance data by timestamp for quick lookup
-    std::unordered_map<long, const Bar*> binanceDataMap;
-    for (const auto& bar : binanceBars) {
-        binanceDataMap[bar.timestamp] = &bar;
-    }
-    
-    // Iterate through Pyth data and combine with Binance data
-    for (const auto& pythBar : pythBars) {
-        Bar combinedBar;
-        
-        // Use OHLC data from Pyth (more accurate pricing)
-        combinedBar.timestamp = pythBar.timestamp;
-        combinedBar.open = pythBar.open;
-        combinedBar.high = pythBar.high;
-        combinedBar.low = pythBar.low;
-        combinedBar.close = pythBar.close;
-        
-        // Try to get volume and trades data from Binance
-        auto binanceIt = binanceDataMap.find(pythBar.timestamp);
-        if (binanceIt != binanceDataMap.end()) {
-            combinedBar.volume = binanceIt->second->volume;
-            combinedBar.num_trades = binanceIt->second->num_trades;
-        } else {
+    combinedBars.reserve(std::max(pythBars.size(), binanceBars.size()));
+
+    // Both inputs are sorted, so one merge pass pairs matching timestamps.
+    auto pyth = pythBars.begin();
+    auto binance = binanceBars.begin();
+    while (pyth != pythBars.end() || binance != binanceBars.end()) {
+        if (binance == binanceBars.end() || (pyth != pythBars.end() && pyth->timestamp < binance->timestamp)) {
             // Fallback to Pyth data if Binance data not available (will be 0 for volume)
-            combinedBar.volume = pythBar.volume;
-            combinedBar.num_trades = pythBar.num_trades;
-            
-            if (pythBar.volume == 0.0) {
-                // Log missing Binance data for debugging
-                std::cout << "Warning: No Binance data found for timestamp " << pythBar.timestamp << std::endl;
+            if (pyth->volume == 0.0) {
+                LOG_DEBUG << "Warning: No Binance data found for timestamp " << pyth->timestamp;
             }
-        }
-        
-        combinedBars.push_back(combinedBar);
-    }
-    
-    // Add any Binance bars that don't have corresponding Pyth data
-    std::unordered_map<long, bool> pythTimestamps;
-    for (const auto& bar : pythBars) {
-        pythTimestamps[bar.timestamp] = true;
-    }
-    
-    for (const auto& binanceBar : binanceBars) {
-        if (pythTimestamps.find(binanceBar.timestamp) == pythTimestamps.end()) {
-            // This Binance bar doesn't have a corresponding Pyth bar
-            // Use Binance data for all fields
-            combinedBars.push_back(binanceBar);
-            std::cout << "Warning: Using Binance OHLC data for timestamp " << binanceBar.timestamp << " (no Pyth data)" << std::endl;
+            combinedBars.push_back(*pyth++);
+        } else if (pyth == pythBars.end() || binance->timestamp < pyth->timestamp) {
+            // No Pyth bar for this timestamp: use Binance data for all fields
+            LOG_DEBUG << "Warning: Using Binance OHLC data for timestamp " << binance->timestamp << " (no Pyth data)";
+            combinedBars.push_back(*binance++);
+        } else {
+            // OHLC from Pyth (more accurate pricing), volume and trades from Binance
+            Bar combinedBar = *pyth++;
+            combinedBar.volume = binance->volume;
+            combinedBar.num_trades = binance->num_trades;
+            ++binance;
+            combinedBars.push_back(combinedBar);
         }
     }
-    
-    // Sort by timestamp to ensure proper ordering
-    std::sort(combinedBars.begin(), combinedBars.end(), [](const Bar& a, const Bar& b) {
-        return a.timestamp < b.timestamp;
-    });
-    
-    std::cout << "Successfully combined " << pythBars.size() << " Pyth bars with " 
-              << binanceBars.size() << " Binance bars into " << combinedBars.size() << " combined bars." << std::endl;
-    
+
+    LOG_INFO << "Successfully combined " << pythBars.size() << " Pyth bars with "
+             << binanceBars.size() << " Binance bars into " << combinedBars.size() << " combined bars.";
+
     return combinedBars;
-} 
\ No newline at end of file
+}
@@ -1,10 +1,10 @@
 #include "data/PythPriceSource.h"
+#include "core/Log.h"
 #include "nlohmann/json.hpp"
 #include <algorithm>
 #include <cpr/cpr.h>
-#include <iostream>
 #include <stdexcept>
-#include <thread> // for std::this_thread::sleep_for
+#include <thread>
 #include <future>
 
 #include "engine/ThreadPool.h"
@@ -21,14 +21,24 @@ const std::map<int, long> PythPriceSource::RESOLUTION_LIMITS = {
 };
 const long ONE_YEAR_SECONDS = 365 * 24 * 60 * 60;
 
-PythPriceSource::PythPriceSource(std::string symbol, std::string resolution, long from, long to)
+// Benchmarks API: 30 requests per 10 seconds per IP; no usage header.
+HttpClient::Config PythPriceSource::httpConfig() {
+    HttpClient::Config config;
+    config.capacity = 30;
+    config.window = std::chrono::seconds{10};
+    return config;
+}
+
+PythPriceSource::PythPriceSource(std::string symbol, std::string resolution, long from, long to,
+                                 std::string baseUrl)
     : symbol_{std::move(symbol)},
       resolution_{std::move(resolution)},
       from_{from},
-      to_{to} {}
+      to_{to},
+      baseUrl_{std::move(baseUrl)},
+      http_{HttpClient::shared(baseUrl_, httpConfig())} {}
 
-std::vector<Bar> PythPriceSource::fetch() {
-    long totalDuration = to_ - from_;
+std::vector<std::pair<long, long>> PythPriceSource::planSegments() const {
     int resolutionInt = 0;
     try {
         resolutionInt = std::stoi(resolution_);
@@ -43,35 +53,42 @@ std::vector<Bar> PythPriceSource::fetch() {
         resolutionLimit = RESOLUTION_LIMITS.at(resolutionInt);
     }
 
+    std::vector<std::pair<long, long>> segments;
+    long currentFrom = from_;
+    while (currentFrom < to_) {
+        long segmentTo = std::min(currentFrom + resolutionLimit, to_);
+        segments.emplace_back(currentFrom, segmentTo);
+        currentFrom = segmentTo;
+    }
+    return segments;
+}
+
+std::vector<Bar> PythPriceSource::fetch() {
+    const auto segments = planSegments();
+
     std::vector<Bar> allBars;
 
-    if (totalDuration <= resolutionLimit) {
+    if (segments.size() <= 1) {
         // Fetch in a single request
-        std::cout << "Total duration within limit. Fetching in a single request." << std::endl;
-        allBars = fetchSegment(from_, to_, false);
+        LOG_INFO << "Total duration within limit. Fetching in a single request.";
+        allBars = fetchSegment(from_, to_);
     } else {
         // Fetch in segments in parallel
-        std::cout << "Total duration exceeds limit. Fetching in parallel segments." << std::endl;
+        LOG_INFO << "Total duration exceeds limit. Fetching in parallel segments.";
         
-        // Cap concurrency to avoid overwhelming the API endpoint.
+        // The shared rate limiter paces requests, so the pool only bounds open connections.
         const size_t max_threads = 8;
         const size_t num_threads = (std::min)(max_threads, static_cast<size_t>(std::thread::hardware_concurrency()));
         ThreadPool pool(num_threads);
         
         std::vector<std::future<std::vector<Bar>>> futures;
 
-        long currentFrom = from_;
-        while (currentFrom < to_) {
-            long segmentTo = std::min(currentFrom + resolutionLimit, to_);
-            
-            std::cout << "Queuing segment from " << currentFrom << " to " << segmentTo << std::endl;
+        for (const auto& [segmentFrom, segmentTo] : segments) {
+            LOG_DEBUG << "Queuing segment from " << segmentFrom << " to " << segmentTo;
             
-            // The pool size provides inherent rate limiting. No artificial delay needed.
             futures.push_back(
-                pool.enqueue(&PythPriceSource::fetchSegment, this, currentFrom, segmentTo, false)
+                pool.enqueue(&PythPriceSource::fetchSegment, this, segmentFrom, segmentTo)
             );
-            
-            currentFrom = segmentTo;
         }
 
         // Collect results from all futures
@@ -80,13 +97,13 @@ std::vector<Bar> PythPriceSource::fetch() {
                 std::vector<Bar> segmentBars = future.get();
                 allBars.insert(allBars.end(), segmentBars.begin(), segmentBars.end());
             } catch (const std::exception& e) {
-                std::cerr << "A segment failed to fetch: " << e.what() << ". Aborting." << std::endl;
+                LOG_ERROR << "A segment failed to fetch: " << e.what() << ". Aborting.";
                 throw; 
             }
         }
     }
     
-    std::cout << "Successfully fetched a total of " << allBars.size() << " bars from Pyth." << std::endl;
+    LOG_INFO << "Successfully fetched a total of " << allBars.size() << " bars from Pyth.";
 
     // Sort and deduplicate
     std::sort(allBars.begin(), allBars.end(), [](const Bar& a, const Bar& b){
@@ -101,24 +118,30 @@ std::vector<Bar> PythPriceSource::fetch() {
     return allBars;
 }
 
-std::vector<Bar> PythPriceSource::fetchSegment(long from, long to, bool addDelay) {
-    if (addDelay) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+std::size_t PythPriceSource::next_batch(std::span<Bar> out) {
+    if (!stream_) {
+        stream_ = std::make_unique<SegmentPrefetcher>(planSegments(), [this](long from, long to) {
+            return fetchSegment(from, to);
+        });
     }
+    return stream_->next_batch(out);
+}
 
-    cpr::Response r = cpr::Get(cpr::Url{baseUrl_ + "/v1/shims/tradingview/history"},
-                               cpr::Parameters{{"symbol", symbol_},
-                                               {"resolution", resolution_},
-                                               {"from", std::to_string(from)},
-                                               {"to", std::to_string(to)}});
-    
-    if (r.status_code != 200) {
-        throw std::runtime_error("Failed to fetch segment from Pyth API: " + r.error.message);
+std::vector<Bar> PythPriceSource::fetchSegment(long from, long to) {
+    cpr::Response r;
+    try {
+        r = http_->get("/v1/shims/tradingview/history",
+                       cpr::Parameters{{"symbol", symbol_},
+                                       {"resolution", resolution_},
+                                       {"from", std::to_string(from)},
+                                       {"to", std::to_string(to)}});
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Failed to fetch segment from Pyth API: " + std::string(e.what()));
     }
     
     // Check for "no_data" status, which is not a failure for a segment
     if (r.text.find("\"s\":\"no_data\"") != std::string::npos) {
-        std::cout << "Pyth returned 'no_data' for segment." << std::endl;
+        LOG_DEBUG << "Pyth returned 'no_data' for segment.";
         return {}; // Return empty vector
     }
     
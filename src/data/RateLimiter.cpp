@@ -0,0 +1,63 @@
+#include "data/RateLimiter.h"
+#include <algorithm>
+#include <stdexcept>
+
+RateLimiter::RateLimiter(double capacity, std::chrono::milliseconds window)
+    : capacity_{capacity},
+      perSecond_{capacity / std::chrono::duration<double>(window).count()},
+      tokens_{capacity},
+      lastRefill_{Clock::now()},
+      pausedUntil_{lastRefill_} {
+    if (!(capacity > 0.0) || window.count() <= 0) {
+        throw std::invalid_argument("RateLimiter needs a positive capacity and window");
+    }
+}
+
+void RateLimiter::refill(Clock::time_point now) {
+    if (now <= lastRefill_) return;
+    tokens_ = std::min(capacity_, tokens_ + perSecond_ * std::chrono::duration<double>(now - lastRefill_).count());
+    lastRefill_ = now;
+}
+
+void RateLimiter::acquire(double cost) {
+    cost = std::min(cost, capacity_);
+    std::unique_lock lock{mutex_};
+    while (true) {
+        const auto now = Clock::now();
+        if (now >= pausedUntil_) {
+            refill(now);
+            if (tokens_ >= cost) {
+                tokens_ -= cost;
+                return;
+            }
+        }
+        // Sleep until the pause ends or the deficit has refilled, whichever
+        // is later; pauseFor() wakes sleepers so they see a longer pause.
+        const auto deficit = std::chrono::duration<double>((cost - tokens_) / perSecond_);
+        const auto refilled = now + std::chrono::duration_cast<Clock::duration>(deficit);
+        wake_.wait_until(lock, std::max(pausedUntil_, refilled));
+    }
+}
+
+void RateLimiter::observeUsed(double used) {
+    std::lock_guard lock{mutex_};
+    refill(Clock::now());
+    tokens_ = std::max(0.0, std::min(tokens_, capacity_ - used));
+}
+
+void RateLimiter::pauseFor(std::chrono::milliseconds delay) {
+    {
+        std::lock_guard lock{mutex_};
+        const auto until = Clock::now() + delay;
+        pausedUntil_ = std::max(pausedUntil_, until);
+        tokens_ = 0.0;
+        lastRefill_ = pausedUntil_;
+    }
+    wake_.notify_all();
+}
+
+double RateLimiter::available() {
+    std::lock_guard lock{mutex_};
+    refill(Clock::now());
+    return tokens_;
+}
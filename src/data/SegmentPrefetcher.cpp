@@ -0,0 +1,49 @@
+#include "data/SegmentPrefetcher.h"
+#include <algorithm>
+
+SegmentPrefetcher::SegmentPrefetcher(std::vector<Segment> segments, FetchFn fetch, std::size_t lookahead)
+    : segments_{std::move(segments)}, fetch_{std::move(fetch)}, lookahead_{std::max<std::size_t>(1, lookahead)} {}
+
+SegmentPrefetcher::~SegmentPrefetcher() {
+    for (auto& future : inFlight_) {
+        if (future.valid()) {
+            future.wait();
+        }
+    }
+}
+
+void SegmentPrefetcher::launchAhead() {
+    while (inFlight_.size() < lookahead_ && nextToLaunch_ < segments_.size()) {
+        const auto [from, to] = segments_[nextToLaunch_++];
+        inFlight_.push_back(std::async(std::launch::async, fetch_, from, to));
+    }
+}
+
+std::size_t SegmentPrefetcher::next_batch(std::span<Bar> out) {
+    std::size_t n = 0;
+    while (n < out.size()) {
+        if (cursor_ == current_.size()) {
+            launchAhead();
+            if (inFlight_.empty()) {
+                break; // all segments consumed
+            }
+            current_ = inFlight_.front().get();
+            inFlight_.pop_front();
+            cursor_ = 0;
+            launchAhead(); // keep the pipeline full while this segment is consumed
+
+            std::sort(current_.begin(), current_.end(), [](const Bar& a, const Bar& b) {
+                return a.timestamp < b.timestamp;
+            });
+            continue;
+        }
+
+        const Bar& bar = current_[cursor_++];
+        if (bar.timestamp <= lastTimestamp_) {
+            continue; // overlap with the previous segment
+        }
+        lastTimestamp_ = bar.timestamp;
+        out[n++] = bar;
+    }
+    return n;
+}
@@ -4,11 +4,47 @@
 #include <nlohmann/json.hpp>
 #include <stdexcept>
 
+void from_json(const nlohmann::json& j, CostConfig& c) {
+    c.makerFeeRate = j.value("makerFeeRate", c.makerFeeRate);
+    c.takerFeeRate = j.value("takerFeeRate", c.takerFeeRate);
+    c.slippageBps = j.value("slippageBps", c.slippageBps);
+    c.volumeImpact = j.value("volumeImpact", c.volumeImpact);
+    c.fundingRate = j.value("fundingRate", c.fundingRate);
+    c.fundingIntervalHours = j.value("fundingIntervalHours", c.fundingIntervalHours);
+}
+
 void from_json(const nlohmann::json& j, StrategyConfig& c) {
     j.at("initialCapital").get_to(c.initialCapital);
     j.at("stopLossPercent").get_to(c.stopLossPercent);
     j.at("takeProfitPercent").get_to(c.takeProfitPercent);
     j.at("perTradeSize").get_to(c.perTradeSize);
+    if (j.contains("maxOpenPositions")) {
+        const auto& count = j.at("maxOpenPositions");
+        if (!count.is_number()) {
+            throw std::invalid_argument("maxOpenPositions must be a whole number >= 1, got " + count.dump());
+        }
+        c.maxOpenPositions = StrategyConfig::positionCount(count.get<double>());
+    }
+    if (j.contains("intrabarPath")) {
+        const auto path = j.at("intrabarPath").get<std::string>();
+        if (path == "stop_first") {
+            c.intrabarPath = IntrabarPath::StopFirst;
+        } else if (path == "ohlc") {
+            c.intrabarPath = IntrabarPath::OpenHighLowClose;
+        } else if (path == "olhc") {
+            c.intrabarPath = IntrabarPath::OpenLowHighClose;
+        } else if (path == "auto") {
+            c.intrabarPath = IntrabarPath::Auto;
+        } else {
+            throw std::runtime_error("Unknown intrabarPath in strategy config: " + path);
+        }
+    }
+    if (j.contains("costs")) {
+        j.at("costs").get_to(c.costs);
+    }
+    if (j.contains("params")) {
+        j.at("params").get_to(c.params);
+    }
 }
 
 void StrategyFactory::registerStrategy(const std::string& name, TCreateMethod createMethod) {
@@ -16,11 +52,14 @@ void StrategyFactory::registerStrategy(const std::string& name, TCreateMethod cr
 }
 
 std::shared_ptr<IStrategy> StrategyFactory::createStrategy(const std::string& name) {
-    auto it = registry_.find(name);
-    if (it == registry_.end()) {
-        throw std::runtime_error("Strategy not found: " + name);
-    }
+    return createStrategy(name, loadConfig(name));
+}
 
+std::shared_ptr<IStrategy> StrategyFactory::createStrategy(const std::string& name, const StrategyConfig& config) const {
+    return getCreateMethod(name)(config);
+}
+
+StrategyConfig StrategyFactory::loadConfig(const std::string& name) const {
     // Load and parse config file
     const std::string configPath = "strategies/" + name + "/config.json";
     std::ifstream f(configPath);
@@ -29,9 +68,15 @@ std::shared_ptr<IStrategy> StrategyFactory::createStrategy(const std::string& na
     }
 
     nlohmann::json data = nlohmann::json::parse(f);
-    StrategyConfig config = data.get<StrategyConfig>();
+    return data.get<StrategyConfig>();
+}
 
-    return it->second(config);
+const StrategyFactory::TCreateMethod& StrategyFactory::getCreateMethod(const std::string& name) const {
+    auto it = registry_.find(name);
+    if (it == registry_.end()) {
+        throw std::runtime_error("Strategy not found: " + name);
+    }
+    return it->second;
 }
 
 std::vector<std::string> StrategyFactory::getRegisteredStrategies() const {
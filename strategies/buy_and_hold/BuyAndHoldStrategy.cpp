@@ -1,12 +1,12 @@
 #include "buy_and_hold/BuyAndHoldStrategy.h"
-#include <iostream>
+#include "core/Log.h"
 #include <vector>
 
 BuyAndHoldStrategy::BuyAndHoldStrategy(const StrategyConfig& config) : config_{config} {}
 
 void BuyAndHoldStrategy::on_start(const Bar&, double) {
-    std::cout << "BuyAndHoldStrategy started with capital: " << config_.initialCapital << std::endl;
-    std::cout << "Stop loss: " << config_.stopLossPercent << "%, Take profit: " << config_.takeProfitPercent << "%" << std::endl;
+    LOG_DEBUG << "BuyAndHoldStrategy started with capital: " << config_.initialCapital;
+    LOG_DEBUG << "Stop loss: " << config_.stopLossPercent << "%, Take profit: " << config_.takeProfitPercent << "%";
 }
 
 StrategyAction BuyAndHoldStrategy::on_bar(const Bar& currentBar,
@@ -28,14 +28,14 @@ StrategyAction BuyAndHoldStrategy::on_bar(const Bar& currentBar,
 
         action.openRequests.push_back(order);
         invested_ = true;
-        std::cout << "STRAT: Placing buy order for " << order.sizeUsd << " USD @ " << entryPrice 
-                  << " SL: " << order.stopLossPrice << " TP: " << order.takeProfitPrice << std::endl;
+        LOG_DEBUG << "STRAT: Placing buy order for " << order.sizeUsd << " USD @ " << entryPrice
+                  << " SL: " << order.stopLossPrice << " TP: " << order.takeProfitPrice;
     }
     return action;
 }
 
 void BuyAndHoldStrategy::on_finish() {
-    std::cout << "BuyAndHoldStrategy finished." << std::endl;
+    LOG_DEBUG << "BuyAndHoldStrategy finished.";
 }
 
 const StrategyConfig& BuyAndHoldStrategy::getConfig() const {
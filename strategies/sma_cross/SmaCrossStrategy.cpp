@@ -1,37 +1,32 @@
 #include "sma_cross/SmaCrossStrategy.h"
-#include <iostream>
-#include <numeric>
+#include "core/Log.h"
+#include "indicators/BatchKernels.h"
 #include <vector>
 
-SmaCrossStrategy::SmaCrossStrategy(const StrategyConfig& config) : config_{config} {}
+SmaCrossStrategy::SmaCrossStrategy(const StrategyConfig& config)
+    : config_{config},
+      smaPeriod_{static_cast<std::size_t>(config.param("smaPeriod", 20))},
+      smoothingPeriod_{static_cast<std::size_t>(config.param("smoothingPeriod", 14))},
+      priceSma_{smaPeriod_},
+      smoothedSma_{smoothingPeriod_} {}
 
 void SmaCrossStrategy::on_start(const Bar&, double) {
-    std::cout << "SmaCrossStrategy started with capital: " << config_.initialCapital << std::endl;
+    LOG_DEBUG << "SmaCrossStrategy started with capital: " << config_.initialCapital;
 }
 
 StrategyAction SmaCrossStrategy::on_bar(const Bar& currentBar,
                                                      const std::vector<Position>& openPositions,
                                                      double) {
-    priceHistory_.push_back(currentBar.close);
-    if (priceHistory_.size() > smaPeriod_) {
-        priceHistory_.pop_front();
-    }
-
-    if (priceHistory_.size() < smaPeriod_) {
+    const double sma = priceSma_.update(currentBar.close);
+    if (!priceSma_.ready()) {
         return {}; // Not enough data yet
     }
-    
-    double sma = std::accumulate(priceHistory_.begin(), priceHistory_.end(), 0.0) / smaPeriod_;
 
-    smaHistory_.push_back(sma);
-    if (smaHistory_.size() > smoothingPeriod_) {
-        smaHistory_.pop_front();
-    }
-
-    if (smaHistory_.size() < smoothingPeriod_) {
+    smoothedSma_.update(sma);
+    if (!smoothedSma_.ready()) {
         return {};
     }
-    currentSma_ = std::accumulate(smaHistory_.begin(), smaHistory_.end(), 0.0) / smoothingPeriod_;
+    currentSma_ = smoothedSma_.value();
 
     // --- Threshold Logic ---
     const double upperBand = currentSma_ * 1.02;
@@ -43,26 +38,56 @@ StrategyAction SmaCrossStrategy::on_bar(const Bar& currentBar,
         Side currentSide = openPositions[0].side;
         if (currentSide == Side::Long && currentBar.close < currentSma_) {
             action.closeCurrentPosition = true;
-            std::cout << "STRAT: Price is below SMA. Signaling to CLOSE LONG." << std::endl;
+            LOG_DEBUG << "STRAT: Price is below SMA. Signaling to CLOSE LONG.";
         } else if (currentSide == Side::Short && currentBar.close > currentSma_) {
             action.closeCurrentPosition = true;
-            std::cout << "STRAT: Price is above SMA. Signaling to CLOSE SHORT." << std::endl;
+            LOG_DEBUG << "STRAT: Price is above SMA. Signaling to CLOSE SHORT.";
         }
     } else { // No position is open
         if (currentBar.close > upperBand) {
             action.openRequests.push_back({.side = Side::Long, .sizeUsd = config_.perTradeSize});
-            std::cout << "STRAT: Price is 2% above SMA. Signaling to OPEN LONG." << std::endl;
+            LOG_DEBUG << "STRAT: Price is 2% above SMA. Signaling to OPEN LONG.";
         } else if (currentBar.close < lowerBand) {
             action.openRequests.push_back({.side = Side::Short, .sizeUsd = config_.perTradeSize});
-            std::cout << "STRAT: Price is 2% below SMA. Signaling to OPEN SHORT." << std::endl;
+            LOG_DEBUG << "STRAT: Price is 2% below SMA. Signaling to OPEN SHORT.";
         }
     }
 
     return action;
 }
 
+void SmaCrossStrategy::on_batch(const BarSeries& bars, std::size_t begin, std::size_t end,
+                                std::span<Signal> out) {
+    // Index (relative to the start of the series) of the first smoothed value.
+    const std::size_t warmup = smaPeriod_ + smoothingPeriod_ - 2;
+    const std::size_t from = begin > warmup ? begin - warmup : 0;
+    const std::size_t count = end - from;
+    if (count <= warmup) {
+        return; // Not enough data yet
+    }
+
+    const double* close = bars.closes().data() + from;
+    batchSma_.resize(count);
+    batchSmoothed_.resize(count);
+    indicators::batch::sma(close, count, smaPeriod_, batchSma_.data());
+    const std::size_t smaStart = smaPeriod_ - 1;
+    indicators::batch::sma(batchSma_.data() + smaStart, count - smaStart, smoothingPeriod_,
+                           batchSmoothed_.data() + smaStart);
+
+    const double size = config_.perTradeSize;
+    for (std::size_t k = std::max(begin - from, warmup); k < count; ++k) {
+        const double c = close[k];
+        const double sma = batchSmoothed_[k];
+        // Exit on a cross back through the SMA; enter 2% beyond it.
+        const auto flags = static_cast<std::uint8_t>(
+            (c < sma ? Signal::ExitLong : 0) | (c > sma ? Signal::ExitShort : 0) |
+            (c > sma * 1.02 ? Signal::EnterLong : 0) | (c < sma * 0.98 ? Signal::EnterShort : 0));
+        out[from + k - begin] = Signal{flags, size};
+    }
+}
+
 void SmaCrossStrategy::on_finish() {
-    std::cout << "SmaCrossStrategy finished." << std::endl;
+    LOG_DEBUG << "SmaCrossStrategy finished.";
 }
 
 const StrategyConfig& SmaCrossStrategy::getConfig() const {
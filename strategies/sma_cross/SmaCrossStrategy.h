@@ -2,8 +2,8 @@
 
 #include "strategy/IStrategy.h"
 #include "strategy/StrategyConfig.h"
+#include "indicators/Sma.h"
 #include <vector>
-#include <deque>
 #include <cstddef>
 
 class SmaCrossStrategy : public IStrategy {
@@ -18,14 +18,27 @@ public:
 
     void on_finish() override;
 
+    // Signals depend only on closes, so whole windows are computed with the
+    // batch SMA kernels (same rules as on_bar, without per-bar logging).
+    // on_bar only enters when flat; on_batch cannot see the open positions
+    // and relies on the engine's room check for that, which only matches
+    // with a single position slot.
+    bool supportsBatch() const override { return config_.maxOpenPositions == 1; }
+
+    void on_batch(const BarSeries& bars, std::size_t begin, std::size_t end, std::span<Signal> out) override;
+
     const StrategyConfig& getConfig() const override;
 
 private:
     StrategyConfig config_;
-    const std::size_t smaPeriod_{20};
-    const std::size_t smoothingPeriod_{14};
+    const std::size_t smaPeriod_;       // params.smaPeriod, default 20
+    const std::size_t smoothingPeriod_; // params.smoothingPeriod, default 14
 
-    std::deque<double> priceHistory_;
-    std::deque<double> smaHistory_;
+    indicators::Sma priceSma_;     // SMA of closes over smaPeriod_
+    indicators::Sma smoothedSma_;  // SMA of priceSma_ over smoothingPeriod_
     double currentSma_{0.0};
+
+    // on_batch scratch, reused across windows.
+    std::vector<double> batchSma_;
+    std::vector<double> batchSmoothed_;
 }; 
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal HTTP/1.1 server on 127.0.0.1 for exercising the price sources
+// without network access. Every connection is served on its own thread (so
+// slow responses overlap like a real endpoint's). By default a connection is
+// closed after one response; with keepAlive it serves requests until the
+// client closes it, and connections() shows whether clients reuse them.
+// The handler may be called concurrently.
+class StubHttpServer {
+public:
+    struct Request {
+        std::string path;
+        std::map<std::string, std::string> query;
+    };
+
+    struct Response {
+        int status{200};
+        std::string body;
+        std::map<std::string, std::string> headers;
+        std::chrono::milliseconds delay{0}; // before the response is sent
+    };
+
+    using Handler = std::function<Response(const Request&)>;
+
+    explicit StubHttpServer(Handler handler, bool keepAlive = false)
+        : handler_{std::move(handler)}, keepAlive_{keepAlive} {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd_ < 0) throw std::runtime_error("StubHttpServer: socket() failed");
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t length = sizeof(addr);
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listenFd_, 64) != 0 ||
+            ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+            ::close(listenFd_);
+            throw std::runtime_error("StubHttpServer: cannot listen on 127.0.0.1");
+        }
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread{[this] { acceptLoop(); }};
+    }
+
+    ~StubHttpServer() {
+        stopping_ = true;
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        acceptor_.join();
+        std::lock_guard lock{mutex_};
+        for (const int fd : open_) ::shutdown(fd, SHUT_RDWR); // wakes idle keep-alive readers
+        for (auto& connection : connections_) connection.join();
+    }
+
+    StubHttpServer(const StubHttpServer&) = delete;
+    StubHttpServer& operator=(const StubHttpServer&) = delete;
+
+    [[nodiscard]] std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+    // Connections accepted so far.
+    [[nodiscard]] std::size_t connections() const { return accepted_.load(); }
+
+private:
+    void acceptLoop() {
+        while (!stopping_) {
+            const int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) {
+                if (stopping_) return;
+                continue;
+            }
+            ++accepted_;
+            std::lock_guard lock{mutex_};
+            open_.push_back(fd);
+            connections_.emplace_back([this, fd] {
+                while (serve(fd) && keepAlive_) {}
+                {
+                    std::lock_guard closing{mutex_};
+                    std::erase(open_, fd);
+                }
+                ::close(fd);
+            });
+        }
+    }
+
+    // Answers one request (GETs only, so no body follows the headers).
+    // Returns false once the client has closed the connection.
+    bool serve(int fd) {
+        std::string raw;
+        char buffer[4096];
+        while (raw.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) return false;
+            raw.append(buffer, static_cast<std::size_t>(n));
+        }
+
+        // "GET /path?a=1&b=2 HTTP/1.1"
+        const std::size_t start = raw.find(' ') + 1;
+        const std::string target = raw.substr(start, raw.find(' ', start) - start);
+        Request request;
+        const std::size_t question = target.find('?');
+        request.path = target.substr(0, question);
+        if (question != std::string::npos) {
+            std::string rest = target.substr(question + 1);
+            while (!rest.empty()) {
+                const std::size_t amp = rest.find('&');
+                const std::string pair = rest.substr(0, amp);
+                const std::size_t eq = pair.find('=');
+                request.query[decode(pair.substr(0, eq))] =
+                    eq == std::string::npos ? "" : decode(pair.substr(eq + 1));
+                rest = amp == std::string::npos ? "" : rest.substr(amp + 1);
+            }
+        }
+
+        const Response response = handler_(request);
+        std::this_thread::sleep_for(response.delay);
+
+        std::string out = "HTTP/1.1 " + std::to_string(response.status) + " Stub\r\n";
+        for (const auto& [name, value] : response.headers) out += name + ": " + value + "\r\n";
+        out += "Content-Type: application/json\r\nContent-Length: " + std::to_string(response.body.size()) +
+               "\r\nConnection: " + (keepAlive_ ? "keep-alive" : "close") + "\r\n\r\n" + response.body;
+        for (std::size_t sent = 0; sent < out.size();) {
+            const ssize_t n = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    static std::string decode(const std::string& s) {
+        std::string out;
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '%' && i + 2 < s.size()) {
+                out += static_cast<char>(std::strtol(s.substr(i + 1, 2).c_str(), nullptr, 16));
+                i += 2;
+            } else {
+                out += s[i] == '+' ? ' ' : s[i];
+            }
+        }
+        return out;
+    }
+
+    Handler handler_;
+    const bool keepAlive_;
+    int listenFd_{-1};
+    int port_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::size_t> accepted_{0};
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::vector<std::thread> connections_;
+    std::vector<int> open_; // connected sockets not yet closed
+};
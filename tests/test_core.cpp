@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 #include "core/Bar.h"
+#include "core/BarSeries.h"
+#include "core/Log.h"
+#include "core/Metrics.h"
 #include "core/OrderRequest.h"
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 TEST(Bar, DefaultConstructible) {
     Bar bar{};
@@ -18,4 +30,185 @@ TEST(OrderRequest, DefaultConstructible) {
     EXPECT_EQ(ord.side, Side::Long);
     EXPECT_DOUBLE_EQ(ord.sizeUsd, 0.0);
     EXPECT_DOUBLE_EQ(ord.leverage, 1.0);
-} 
\ No newline at end of file
+} 
+TEST(BarSeries, ConvertsToAndFromBarsWithAlignedColumns) {
+    const std::vector<Bar> bars = {
+        {1672531200000, 100, 110, 90, 105, 10, 3},
+        {1672531260000, 105, 115, 102, 112, 20, 4},
+        {1672531320000, 112, 120, 110, 118, 30, 5},
+    };
+    const auto series = BarSeries::fromBars(bars);
+    ASSERT_EQ(series.size(), bars.size());
+    EXPECT_DOUBLE_EQ(series.closes()[1], 112);
+    EXPECT_DOUBLE_EQ(series.highs()[2], 120);
+    EXPECT_EQ(series.row(0).num_trades, 3);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(series.closes().data()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(series.timestamps().data()) % 64, 0u);
+
+    const auto back = series.toBars();
+    ASSERT_EQ(back.size(), bars.size());
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        EXPECT_EQ(back[i].timestamp, bars[i].timestamp);
+        EXPECT_DOUBLE_EQ(back[i].low, bars[i].low);
+        EXPECT_DOUBLE_EQ(back[i].volume, bars[i].volume);
+    }
+}
+
+TEST(Metrics, RunningStatsMatchesTwoPass) {
+    const std::vector<double> xs{0.01, -0.02, 0.005, 0.03, -0.01, 0.0, 0.015};
+    metrics::RunningStats stats;
+    double sum = 0.0;
+    for (double x : xs) {
+        stats.add(x);
+        sum += x;
+    }
+    const double mean = sum / static_cast<double>(xs.size());
+    double sq = 0.0;
+    for (double x : xs) {
+        sq += (x - mean) * (x - mean);
+    }
+    EXPECT_EQ(stats.count(), xs.size());
+    EXPECT_NEAR(stats.mean(), mean, 1e-15);
+    EXPECT_NEAR(stats.variance(), sq / static_cast<double>(xs.size() - 1), 1e-15);
+}
+
+TEST(Metrics, EquityTrackerStreamsDrawdownAndRatios) {
+    constexpr std::int64_t day = 24 * 3'600'000;
+    metrics::EquityTracker tracker{100.0};
+    const double curve[] = {110.0, 99.0, 121.0, 108.9};
+    for (std::int64_t i = 0; i < 4; ++i) {
+        tracker.mark(i * day, curve[i], i != 1);
+    }
+    tracker.addTraded(219.9);
+
+    const auto m = tracker.summarize();
+    EXPECT_EQ(m.bars, 4u);
+    EXPECT_DOUBLE_EQ(m.finalEquity, 108.9);
+    EXPECT_NEAR(m.totalReturn, 0.089, 1e-12);
+    EXPECT_NEAR(m.maxDrawdown, 0.1, 1e-12); // 110 -> 99 and 121 -> 108.9
+    EXPECT_NEAR(tracker.drawdown(), 0.1, 1e-12);
+    EXPECT_DOUBLE_EQ(m.exposure, 0.75);
+    EXPECT_NEAR(m.turnover, 219.9 / ((110.0 + 99.0 + 121.0 + 108.9) / 4.0), 1e-12);
+
+    // Bar returns +10%, -10%, +22.2%, -10%, one bar per day.
+    const double r[] = {0.1, -0.1, 121.0 / 99.0 - 1.0, -0.1};
+    metrics::RunningStats stats;
+    double downside = 0.0;
+    for (double x : r) {
+        stats.add(x);
+        downside += x < 0 ? x * x : 0.0;
+    }
+    const double scale = std::sqrt(365.0);
+    EXPECT_NEAR(m.sharpe, stats.mean() / stats.stdDev() * scale, 1e-9);
+    EXPECT_NEAR(m.sortino, stats.mean() / std::sqrt(downside / 4.0) * scale, 1e-9);
+    EXPECT_NEAR(m.annualReturn, std::pow(1.089, 365.0 / 3.0) - 1.0, 1e-6 * m.annualReturn);
+    EXPECT_NEAR(m.calmar, m.annualReturn / 0.1, 1e-6 * m.calmar);
+}
+
+TEST(Log, RuntimeLevelSkipsStatementsWithoutEvaluatingThem) {
+    const auto previous = logging::level();
+    int evaluated = 0;
+    auto count = [&evaluated] { return ++evaluated; };
+
+    logging::setLevel(logging::Level::Warn);
+    EXPECT_FALSE(logging::enabled(logging::Level::Info));
+    EXPECT_TRUE(logging::enabled(logging::Level::Error));
+    LOG_INFO << "skipped " << count();
+    EXPECT_EQ(evaluated, 0);
+
+    logging::setLevel(logging::Level::Off);
+    EXPECT_FALSE(logging::enabled(logging::Level::Error));
+    LOG_ERROR << "skipped " << count();
+    EXPECT_EQ(evaluated, 0);
+
+    logging::setLevel(logging::Level::Trace);
+    LOG_TRACE << "log test line " << count();
+    EXPECT_EQ(evaluated, 1);
+    logging::flush();
+
+    EXPECT_EQ(logging::parseLevel("debug"), logging::Level::Debug);
+    EXPECT_THROW(logging::parseLevel("verbose"), std::invalid_argument);
+    EXPECT_THROW(logging::parseLevel("INFO"), std::invalid_argument);
+    EXPECT_THROW(logging::parseLevel(""), std::invalid_argument);
+    logging::setLevel(previous);
+}
+
+TEST(Log, ThreadsLogConcurrentlyAndFlush) {
+    const auto previous = logging::level();
+    logging::setLevel(logging::Level::Debug);
+    testing::internal::CaptureStdout();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 250; ++i) {
+                LOG_DEBUG << "thread " << t << " line " << i;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join(); // exiting threads hand off their buffers
+    }
+    logging::flush();
+    const std::string output = testing::internal::GetCapturedStdout();
+    logging::setLevel(previous);
+
+    // Every line arrives whole, and each thread's lines in order.
+    std::istringstream lines{output};
+    std::string line;
+    int next[4] = {0, 0, 0, 0};
+    int total = 0;
+    while (std::getline(lines, line)) {
+        int t = -1;
+        int i = -1;
+        char rest = 0;
+        ASSERT_EQ(std::sscanf(line.c_str(), "thread %d line %d%c", &t, &i, &rest), 2) << line;
+        ASSERT_TRUE(t >= 0 && t < 4) << line;
+        EXPECT_EQ(i, next[t]) << line;
+        next[t] = i + 1;
+        ++total;
+    }
+    EXPECT_EQ(total, 1000);
+}
+
+TEST(Log, FlushCollectsLinesFromLiveThreads) {
+    const auto previous = logging::level();
+    logging::setLevel(logging::Level::Info);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool logged = false;
+    bool done = false;
+
+    testing::internal::CaptureStdout();
+    std::thread worker{[&] {
+        LOG_INFO << "worker progress";
+        std::unique_lock lock{mutex};
+        logged = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return done; }); // stays alive until checked
+    }};
+    {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [&] { return logged; });
+    }
+    logging::flush();
+    const std::string flushed = testing::internal::GetCapturedStdout();
+
+    // Without any flush, a line from a live thread logging too little to
+    // fill its buffer still goes out on the flusher's timer.
+    testing::internal::CaptureStdout();
+    LOG_INFO << "main progress";
+    std::this_thread::sleep_for(std::chrono::milliseconds{500});
+    const std::string timed = testing::internal::GetCapturedStdout();
+
+    {
+        std::lock_guard lock{mutex};
+        done = true;
+    }
+    cv.notify_all();
+    worker.join();
+    logging::flush();
+    logging::setLevel(previous);
+
+    EXPECT_NE(flushed.find("worker progress\n"), std::string::npos);
+    EXPECT_NE(timed.find("main progress\n"), std::string::npos);
+}
@@ -2,6 +2,26 @@
 #include "data/CsvPriceSource.h"
 #include "data/PythPriceSource.h"
 #include "data/Aggregator.h"
+#include "data/BarFile.h"
+#include "data/BarStore.h"
+#include "data/BinancePriceSource.h"
+#include "data/BinaryPriceSource.h"
+#include "data/CsvParser.h"
+#include "data/HttpClient.h"
+#include "data/MmapPriceSource.h"
+#include "data/PriceManager.h"
+#include "data/RateLimiter.h"
+#include "data/SegmentPrefetcher.h"
+#include "StubHttpServer.h"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <thread>
 
 TEST(CsvPriceSource, ReadsDataCorrectly) {
     CsvPriceSource source{"../../price_history/BTCUSD-1m-test.csv"};
@@ -27,6 +47,139 @@ TEST(CsvPriceSource, ThrowsOnMissingFile) {
     EXPECT_THROW(source.fetch(), std::runtime_error);
 }
 
+TEST(CsvParser, ParsesOptionalNumTradesAndLineEndings) {
+    const std::string text =
+        "timestamp,open,high,low,close,volume,num_trades\r\n"
+        "1672531200000,16546.800000,16547.2,16546.5,16547.0,100.5,12\r\n"
+        "\n"
+        "1672531260000,16547,16548.5,16546,16548,1e2\n"
+        "1672531320000,16548.0,16550.0,16547.5,16549.5,80.25,7";
+
+    const auto body = csv::skipHeader(text);
+    std::vector<Bar> bars;
+    csv::parseBars(body, bars);
+
+    ASSERT_EQ(bars.size(), 3u);
+    EXPECT_EQ(bars[0].timestamp, 1672531200000);
+    EXPECT_DOUBLE_EQ(bars[0].open, 16546.8);
+    EXPECT_EQ(bars[0].num_trades, 12);
+    EXPECT_DOUBLE_EQ(bars[1].volume, 100.0);
+    EXPECT_EQ(bars[1].num_trades, 0); // old files have no num_trades column
+    EXPECT_DOUBLE_EQ(bars[2].close, 16549.5);
+    EXPECT_EQ(bars[2].num_trades, 7);
+    EXPECT_GE(csv::estimateRows(body), 1u);
+}
+
+TEST(CsvParser, ThrowsOnMalformedLine) {
+    std::vector<Bar> bars;
+    EXPECT_THROW(csv::parseBars("1672531200000,abc,1,1,1,1\n", bars), std::runtime_error);
+    EXPECT_THROW(csv::parseBars("1672531200000,1,1,1\n", bars), std::runtime_error);
+}
+
+TEST(CsvPriceSource, RoundTripsThroughWrite) {
+    const std::string path = (std::filesystem::temp_directory_path() / "csv_roundtrip.csv").string();
+    std::vector<Bar> bars = {
+        {1672531200000, 100.5, 110.25, 90.125, 105.0, 10.5, 7},
+        {1672531260000, 105.0, 115.0, 102.0, 112.0, 20.0, 0},
+    };
+    CsvPriceSource::write(path, bars);
+
+    auto loaded = CsvPriceSource{path}.fetch();
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded[1].timestamp, 1672531260000);
+    EXPECT_DOUBLE_EQ(loaded[0].low, 90.125);
+    EXPECT_EQ(loaded[0].num_trades, 7);
+    std::filesystem::remove(path);
+}
+
+TEST(CsvParser, SplitsChunksAtLineBoundaries) {
+    const std::string body = "1,1,1,1,1,1\n2,2,2,2,2,2\n3,3,3,3,3,3\n4,4,4,4,4,4\n5,5,5,5,5,5";
+    const auto chunks = csv::splitChunks(body, 3);
+    ASSERT_GE(chunks.size(), 2u);
+
+    std::string joined;
+    std::vector<Bar> bars;
+    for (const auto chunk : chunks) {
+        EXPECT_TRUE(chunk.back() == '\n' || chunk.data() + chunk.size() == body.data() + body.size());
+        joined += chunk;
+        csv::parseBars(chunk, bars);
+    }
+    EXPECT_EQ(joined, body);
+    ASSERT_EQ(bars.size(), 5u);
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        EXPECT_EQ(bars[i].timestamp, static_cast<std::int64_t>(i + 1));
+    }
+}
+
+TEST(CsvPriceSource, ParallelParseMatchesSerial) {
+    const std::string path = (std::filesystem::temp_directory_path() / "csv_parallel.csv").string();
+    std::vector<Bar> bars;
+    // Enough rows to cross the parallel threshold.
+    const std::size_t rows = CsvPriceSource::kParallelThresholdBytes / 40;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double p = 100.0 + static_cast<double>(i % 97);
+        bars.push_back({static_cast<std::int64_t>(i) * 60000, p, p + 1, p - 1, p, 1.5, static_cast<std::int64_t>(i)});
+    }
+    CsvPriceSource::write(path, bars);
+
+    auto serial = CsvPriceSource{path, 1}.fetch();
+    auto parallel = CsvPriceSource{path, 4}.fetch();
+    ASSERT_EQ(serial.size(), rows);
+    ASSERT_EQ(parallel.size(), rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(parallel[i].timestamp, serial[i].timestamp);
+        ASSERT_EQ(parallel[i].num_trades, serial[i].num_trades);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(CsvPriceSource, StreamsInBatchesAcrossReadBlocks) {
+    const std::string path = (std::filesystem::temp_directory_path() / "csv_stream.csv").string();
+    std::vector<Bar> bars;
+    // Larger than one read block, so lines straddle block boundaries.
+    const std::size_t rows = CsvPriceSource::kStreamBlockBytes / 30;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double p = 100.0 + static_cast<double>(i % 13);
+        bars.push_back({static_cast<std::int64_t>(i) * 60000, p, p + 1, p - 1, p, 2.0, static_cast<std::int64_t>(i)});
+    }
+    CsvPriceSource::write(path, bars);
+
+    CsvPriceSource source{path};
+    std::vector<Bar> batch(777);
+    std::vector<Bar> streamed;
+    while (std::size_t n = source.next_batch(batch)) {
+        streamed.insert(streamed.end(), batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    ASSERT_EQ(streamed.size(), rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(streamed[i].timestamp, bars[i].timestamp);
+        ASSERT_EQ(streamed[i].num_trades, bars[i].num_trades);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(SegmentPrefetcher, StreamsSegmentsInOrderAndDropsOverlap) {
+    // Each segment [from, to) yields one bar per second, including the bar at `to`.
+    auto fetch = [](long from, long to) {
+        std::vector<Bar> bars;
+        for (long t = to; t >= from; --t) { // deliberately unsorted
+            bars.push_back({t * 1000, 1, 1, 1, 1, 1});
+        }
+        return bars;
+    };
+    SegmentPrefetcher stream{{{0, 3}, {3, 6}, {6, 9}}, fetch, 2};
+
+    std::vector<Bar> batch(4);
+    std::vector<std::int64_t> timestamps;
+    while (std::size_t n = stream.next_batch(batch)) {
+        for (std::size_t i = 0; i < n; ++i) {
+            timestamps.push_back(batch[i].timestamp / 1000);
+        }
+    }
+    std::vector<std::int64_t> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(timestamps, expected);
+}
+
 // Friend class to access private members of PythPriceSource
 class PythPriceSourceTest : public ::testing::Test {
 protected:
@@ -99,4 +252,575 @@ TEST(Aggregator, AggregatesCorrectly) {
     EXPECT_DOUBLE_EQ(fiveMinBar.low, 90);
     EXPECT_DOUBLE_EQ(fiveMinBar.close, 123);
     EXPECT_DOUBLE_EQ(fiveMinBar.volume, 10 + 20 + 30 + 40 + 50);
-} 
\ No newline at end of file
+}
+
+TEST(Aggregator, SeriesAggregationMatchesRowAggregation) {
+    std::vector<Bar> raw;
+    for (int i = 0; i < 97; ++i) {
+        const double p = 100.0 + (i % 11) - (i % 4);
+        raw.push_back({1672531200000 + i * 60000LL, p, p + (i % 3), p - (i % 5), p + 1, 1.0 + i, i});
+    }
+    const Aggregator aggregator{15};
+    const auto expected = aggregator.aggregate(raw);
+    const auto series = aggregator.aggregate(BarSeries::fromBars(raw));
+
+    ASSERT_EQ(series.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        const Bar bar = series.row(i);
+        EXPECT_EQ(bar.timestamp, expected[i].timestamp);
+        EXPECT_DOUBLE_EQ(bar.open, expected[i].open);
+        EXPECT_DOUBLE_EQ(bar.high, expected[i].high);
+        EXPECT_DOUBLE_EQ(bar.low, expected[i].low);
+        EXPECT_DOUBLE_EQ(bar.close, expected[i].close);
+        EXPECT_DOUBLE_EQ(bar.volume, expected[i].volume);
+        EXPECT_EQ(bar.num_trades, expected[i].num_trades);
+    }
+}
+
+TEST(BarFile, RoundTripsBars) {
+    const std::string path = (std::filesystem::temp_directory_path() / "bar_file_roundtrip.bin").string();
+    std::vector<Bar> bars = {
+        {1672531200000, 100.5, 110.25, 90.125, 105.0, 10.5, 7},
+        {1672531260000, 105.0, 115.0, 102.0, 112.0, 20.0, 0},
+        {1672531320000, 112.0, 120.0, 110.0, 118.0, 30.0, 42},
+    };
+    barfile::write(path, bars);
+    EXPECT_EQ(std::filesystem::file_size(path), barfile::fileSize(bars.size()));
+
+    BinaryPriceSource source{path};
+    auto loaded = source.fetch();
+    ASSERT_EQ(loaded.size(), bars.size());
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        EXPECT_EQ(loaded[i].timestamp, bars[i].timestamp);
+        EXPECT_DOUBLE_EQ(loaded[i].open, bars[i].open);
+        EXPECT_DOUBLE_EQ(loaded[i].high, bars[i].high);
+        EXPECT_DOUBLE_EQ(loaded[i].low, bars[i].low);
+        EXPECT_DOUBLE_EQ(loaded[i].close, bars[i].close);
+        EXPECT_DOUBLE_EQ(loaded[i].volume, bars[i].volume);
+        EXPECT_EQ(loaded[i].num_trades, bars[i].num_trades);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(BarFile, ReadsAndWritesSeriesColumns) {
+    const std::string path = (std::filesystem::temp_directory_path() / "bar_file_series.bin").string();
+    const std::vector<Bar> bars = {
+        {1672531200000, 100.5, 110.25, 90.125, 105.0, 10.5, 7},
+        {1672531260000, 105.0, 115.0, 102.0, 112.0, 20.0, 0},
+    };
+    barfile::write(path, BarSeries::fromBars(bars));
+
+    // Files written from a series and from rows are interchangeable.
+    const auto rows = barfile::read(path);
+    ASSERT_EQ(rows.size(), bars.size());
+    EXPECT_DOUBLE_EQ(rows[1].close, 112.0);
+
+    barfile::write(path, bars);
+    const auto series = barfile::readSeries(path);
+    ASSERT_EQ(series.size(), bars.size());
+    EXPECT_EQ(series.timestamps()[1], 1672531260000);
+    EXPECT_DOUBLE_EQ(series.lows()[0], 90.125);
+    EXPECT_EQ(series.numTrades()[0], 7);
+    std::filesystem::remove(path);
+}
+
+TEST(BarFile, RejectsCorruptedPayload) {
+    const std::string path = (std::filesystem::temp_directory_path() / "bar_file_corrupt.bin").string();
+    barfile::write(path, {{1672531200000, 100, 110, 90, 105, 10, 1}});
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(barfile::columnOffset(1, barfile::Column::Close));
+        const char garbage = 0x7f;
+        file.write(&garbage, 1);
+    }
+    EXPECT_THROW(barfile::read(path), std::runtime_error);
+
+    std::filesystem::resize_file(path, barfile::fileSize(1) - 8);
+    EXPECT_THROW(barfile::read(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(MmapPriceSource, ExposesColumnsWithoutCopying) {
+    const std::string path = (std::filesystem::temp_directory_path() / "mmap_source.bin").string();
+    std::vector<Bar> bars = {
+        {1672531200000, 100, 110, 90, 105, 10, 3},
+        {1672531260000, 105, 115, 102, 112, 20, 4},
+    };
+    barfile::write(path, bars);
+
+    MmapPriceSource first{path};
+    MmapPriceSource second{path};
+    const auto& view = first.view();
+    ASSERT_EQ(view.size(), 2u);
+    EXPECT_EQ(view.timestamp[1], 1672531260000);
+    EXPECT_DOUBLE_EQ(view.high[0], 110);
+    EXPECT_DOUBLE_EQ(view.close[1], 112);
+    EXPECT_EQ(view.num_trades[1], 4);
+
+    // Both sources in this process share one mapping.
+    EXPECT_EQ(view.close.data(), second.view().close.data());
+
+    auto copied = second.fetch();
+    ASSERT_EQ(copied.size(), 2u);
+    EXPECT_DOUBLE_EQ(copied[0].low, 90);
+    EXPECT_DOUBLE_EQ(copied[1].volume, 20);
+    std::filesystem::remove(path);
+}
+
+namespace {
+
+// Serves a fixed vector through the default PriceSource::next_batch.
+class VectorPriceSource : public PriceSource {
+public:
+    explicit VectorPriceSource(std::vector<Bar> bars) : bars_{std::move(bars)} {}
+    std::vector<Bar> fetch() override { return bars_; }
+
+private:
+    std::vector<Bar> bars_;
+};
+
+} // namespace
+
+TEST(AggregatedPriceSource, MatchesBatchAggregation) {
+    std::vector<Bar> raw;
+    for (int i = 0; i < 97; ++i) {
+        const double p = 100.0 + (i % 11);
+        raw.push_back({1672531200000 + i * 60000LL, p, p + 2, p - 2, p + 1, 1.0 + i, i});
+    }
+    const auto expected = Aggregator{15}.aggregate(raw);
+
+    AggregatedPriceSource source{std::make_shared<VectorPriceSource>(raw), 15, 10};
+    std::vector<Bar> batch(2);
+    std::vector<Bar> streamed;
+    while (std::size_t n = source.next_batch(batch)) {
+        streamed.insert(streamed.end(), batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+
+    ASSERT_EQ(streamed.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(streamed[i].timestamp, expected[i].timestamp);
+        EXPECT_DOUBLE_EQ(streamed[i].open, expected[i].open);
+        EXPECT_DOUBLE_EQ(streamed[i].high, expected[i].high);
+        EXPECT_DOUBLE_EQ(streamed[i].low, expected[i].low);
+        EXPECT_DOUBLE_EQ(streamed[i].close, expected[i].close);
+        EXPECT_DOUBLE_EQ(streamed[i].volume, expected[i].volume);
+        EXPECT_EQ(streamed[i].num_trades, expected[i].num_trades);
+    }
+}
+
+TEST(MultiResolutionAggregator, FansOutMatchingPerResolutionAggregation) {
+    std::vector<Bar> raw;
+    for (int i = 0; i < 600; ++i) {
+        const double p = 100.0 + (i % 37) - (i % 5);
+        raw.push_back({1672531200000 + i * 60000LL, p, p + 1, p - 1, p + 0.5, 1.0, 1});
+    }
+
+    std::map<std::size_t, std::vector<Bar>> emitted;
+    MultiResolutionAggregator aggregator({1, 15, 240}, [&](std::size_t resolution, const Bar& bar) {
+        emitted[resolution].push_back(bar);
+    });
+    aggregator.push(std::span<const Bar>{raw.data(), 250});
+    for (std::size_t i = 250; i < raw.size(); ++i) {
+        aggregator.push(raw[i]);
+    }
+    aggregator.flush();
+
+    for (std::size_t resolution : {1u, 15u, 240u}) {
+        const auto expected = Aggregator{resolution}.aggregate(raw);
+        const auto& actual = emitted[resolution];
+        ASSERT_EQ(actual.size(), expected.size()) << resolution << "m";
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(actual[i].timestamp, expected[i].timestamp);
+            EXPECT_DOUBLE_EQ(actual[i].high, expected[i].high);
+            EXPECT_DOUBLE_EQ(actual[i].low, expected[i].low);
+            EXPECT_DOUBLE_EQ(actual[i].close, expected[i].close);
+            EXPECT_DOUBLE_EQ(actual[i].volume, expected[i].volume);
+        }
+    }
+}
+
+TEST(PriceManager, FetchesOnlyDaysMissingFromTheBarStore) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "bar_store_test";
+    fs::remove_all(root);
+
+    constexpr long kDay = BarStore::kPartitionSeconds;
+    constexpr long kStart = 1672531200; // 2023-01-01 00:00 UTC
+    std::vector<std::pair<long, long>> requests;
+    auto fetcher = [&requests](long from, long to) {
+        requests.emplace_back(from, to);
+        std::vector<Bar> bars;
+        for (long t = from; t <= to; t += 3600) {
+            if (t >= kStart + 5 * kDay) break; // the source has nothing from day 5 on
+            bars.push_back({static_cast<std::int64_t>(t) * 1000, 1, 1, 1, static_cast<double>(t), 1, 1});
+        }
+        return bars;
+    };
+    auto load = [&](long from, long to) {
+        return PriceManager{"Crypto.BTC/USD", "1", from, to, root.string(), fetcher}.loadData();
+    };
+
+    // Days 0-2 are fetched whole, then trimmed to the request.
+    auto bars = load(kStart + 10 * 3600, kStart + 2 * kDay + 5 * 3600);
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0], std::make_pair(kStart, kStart + 3 * kDay - 1));
+    ASSERT_EQ(bars.size(), 14u + 24u + 6u);
+    EXPECT_EQ(bars.front().timestamp, (kStart + 10 * 3600) * 1000LL);
+    EXPECT_EQ(bars.back().timestamp, (kStart + 2 * kDay + 5 * 3600) * 1000LL);
+    EXPECT_TRUE(fs::exists(root / "Crypto_BTC_USD" / "1" / "2023-01-02.bin"));
+
+    // An overlapping window fetches only days 3-6; days 5-6 are cached empty.
+    bars = load(kStart + kDay, kStart + 7 * kDay - 1);
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[1], std::make_pair(kStart + 3 * kDay, kStart + 7 * kDay - 1));
+    ASSERT_EQ(bars.size(), 4u * 24u);
+    for (std::size_t i = 1; i < bars.size(); ++i) {
+        EXPECT_EQ(bars[i].timestamp - bars[i - 1].timestamp, 3600 * 1000);
+    }
+
+    // Anything inside the cached days is served without fetching.
+    bars = load(kStart + 4 * 3600, kStart + 6 * kDay);
+    EXPECT_EQ(requests.size(), 2u);
+    EXPECT_EQ(bars.size(), 5u * 24u - 4u);
+
+    fs::remove_all(root);
+}
+
+TEST(PriceManager, RefetchesCorruptDayPartitions) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "bar_store_corrupt";
+    fs::remove_all(root);
+
+    constexpr long kDay = BarStore::kPartitionSeconds;
+    constexpr long kStart = 1672531200;
+    std::vector<std::pair<long, long>> requests;
+    auto fetcher = [&requests](long from, long to) {
+        requests.emplace_back(from, to);
+        std::vector<Bar> bars;
+        for (long t = from; t <= to; t += 3600) {
+            bars.push_back({static_cast<std::int64_t>(t) * 1000, 1, 1, 1, 1, 1, 1});
+        }
+        return bars;
+    };
+    auto load = [&](long from, long to) {
+        return PriceManager{"SYM", "1", from, to, root.string(), fetcher}.loadData();
+    };
+
+    ASSERT_EQ(load(kStart, kStart + 3 * kDay - 1).size(), 3u * 24u);
+    ASSERT_EQ(requests.size(), 1u);
+
+    // Truncate day 1 and garble day 2.
+    const fs::path dir = root / "SYM" / "1";
+    fs::resize_file(dir / "2023-01-02.bin", 10);
+    std::ofstream{dir / "2023-01-03.bin", std::ios::binary | std::ios::trunc} << "not a bar file";
+
+    // Both days are fetched again and rewritten; day 0 still comes from disk.
+    auto bars = load(kStart, kStart + 3 * kDay - 1);
+    ASSERT_EQ(bars.size(), 3u * 24u);
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[1], std::make_pair(kStart + kDay, kStart + 3 * kDay - 1));
+    for (std::size_t i = 1; i < bars.size(); ++i) {
+        EXPECT_EQ(bars[i].timestamp - bars[i - 1].timestamp, 3600 * 1000);
+    }
+    EXPECT_EQ(load(kStart, kStart + 3 * kDay - 1).size(), 3u * 24u);
+    EXPECT_EQ(requests.size(), 2u);
+
+    fs::remove_all(root);
+}
+
+TEST(PriceManager, RefetchAfterCorruptPartitionKeepsBarsUnique) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "bar_store_corrupt_recent";
+    fs::remove_all(root);
+
+    constexpr long kDay = BarStore::kPartitionSeconds;
+    const long now = std::time(nullptr);
+    // Yesterday is stored; today is still in progress and never is.
+    const long yesterday = BarStore::partitionStart(now) - kDay;
+    const long from = yesterday - kDay;
+    const long to = std::min(now, BarStore::partitionStart(now) + kDay - 1);
+    if (BarStore::partitionStart(now) + BarStore::kSettleSeconds > now) {
+        GTEST_SKIP() << "yesterday has not settled yet";
+    }
+
+    std::vector<std::pair<long, long>> requests;
+    auto fetcher = [&requests](long a, long b) {
+        requests.emplace_back(a, b);
+        std::vector<Bar> bars;
+        for (long t = a; t <= b; t += 3600) {
+            bars.push_back({static_cast<std::int64_t>(t) * 1000, 1, 1, 1, 1, 1, 1});
+        }
+        return bars;
+    };
+    auto load = [&] { return PriceManager{"SYM", "60", from, to, root.string(), fetcher}.loadData(); };
+
+    const std::size_t expected = load().size();
+    ASSERT_EQ(requests.size(), 1u);
+
+    // Corrupt the first (stored) day; today is fetched again as usual.
+    BarStore store{root.string(), "SYM", "60"};
+    ASSERT_TRUE(store.hasPartition(from));
+    fs::resize_file(store.partitionPath(from), 10);
+    const auto bars = load();
+
+    EXPECT_EQ(bars.size(), expected);
+    for (std::size_t i = 1; i < bars.size(); ++i) {
+        ASSERT_LT(bars[i - 1].timestamp, bars[i].timestamp) << "duplicate or unsorted bar at " << i;
+    }
+    // Pass 0 fetched today, pass 1 only the corrupt day.
+    ASSERT_EQ(requests.size(), 3u);
+    EXPECT_EQ(requests[2], std::make_pair(from, from + kDay - 1));
+
+    fs::remove_all(root);
+}
+
+TEST(BarStore, LeavesDaysInProgressUncached) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "bar_store_open_day";
+    fs::remove_all(root);
+    BarStore store{root.string(), "SYM", "1"};
+
+    constexpr long kStart = 1672531200;
+    const std::vector<Bar> bars = {{kStart * 1000LL, 1, 1, 1, 1, 1, 1}, {(kStart + 86400) * 1000LL, 2, 2, 2, 2, 2, 2}};
+    // A day that ended minutes ago may still be missing late bars.
+    EXPECT_EQ(store.store(bars, kStart, kStart + 2 * 86400 - 1, kStart + 86400 + 600), 0u);
+    EXPECT_FALSE(store.hasPartition(kStart));
+    // "now" is midway through the second day.
+    EXPECT_EQ(store.store(bars, kStart, kStart + 2 * 86400 - 1, kStart + 86400 + 6 * 3600), 1u);
+    EXPECT_TRUE(store.hasPartition(kStart));
+    EXPECT_FALSE(store.hasPartition(kStart + 86400));
+    EXPECT_EQ(store.missingRanges(kStart, kStart + 2 * 86400 - 1),
+              (std::vector<std::pair<long, long>>{{kStart + 86400, kStart + 2 * 86400 - 1}}));
+    EXPECT_EQ(store.load(kStart, kStart + 2 * 86400 - 1).size(), 1u);
+    EXPECT_EQ(BarStore::partitionsFor(kStart - 1, kStart).size(), 2u);
+
+    fs::remove_all(root);
+}
+
+namespace {
+
+// Pyth history body with one bar per timestamp (seconds).
+std::string pythBody(const std::vector<long>& seconds) {
+    nlohmann::json t = nlohmann::json::array(), price = nlohmann::json::array(), volume = nlohmann::json::array();
+    for (long ts : seconds) {
+        t.push_back(ts);
+        price.push_back(static_cast<double>(ts % 1000));
+        volume.push_back(0.0);
+    }
+    return nlohmann::json{{"s", "ok"}, {"t", t}, {"o", price}, {"h", price}, {"l", price}, {"c", price}, {"v", volume}}
+        .dump();
+}
+
+// Binance klines body with one kline per timestamp (seconds); volume 5, 9 trades.
+std::string binanceBody(const std::vector<long>& seconds) {
+    nlohmann::json klines = nlohmann::json::array();
+    for (long ts : seconds) {
+        klines.push_back({ts * 1000, "1.0", "2.0", "0.5", "1.5", "5.0", ts * 1000 + 59999, "7.5", 9});
+    }
+    return klines.dump();
+}
+
+} // namespace
+
+TEST(PriceManager, FetchesPythAndBinanceConcurrentlyAndMerges) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "price_manager_stub";
+    fs::remove_all(root);
+    constexpr long kStart = 1672531200;
+
+    using Clock = std::chrono::steady_clock;
+    std::mutex mutex;
+    std::map<std::string, std::pair<Clock::time_point, Clock::time_point>> served;
+    StubHttpServer server{[&](const StubHttpServer::Request& request) {
+        StubHttpServer::Response response;
+        if (request.path == "/v1/shims/tradingview/history") {
+            EXPECT_EQ(request.query.at("symbol"), "Crypto.BTC/USD");
+            EXPECT_EQ(request.query.at("from"), std::to_string(kStart));
+            response.body = pythBody({kStart, kStart + 60, kStart + 120});
+            response.delay = std::chrono::milliseconds{1000};
+        } else if (request.path == "/fapi/v1/klines") {
+            EXPECT_EQ(request.query.at("startTime"), std::to_string(kStart * 1000L));
+            response.body = binanceBody({kStart + 60, kStart + 120, kStart + 180});
+            response.delay = std::chrono::milliseconds{500};
+        } else {
+            response.status = 404;
+        }
+        std::lock_guard lock{mutex};
+        served[request.path] = {Clock::now(), Clock::now() + response.delay};
+        return response;
+    }};
+
+    PriceManager manager{"Crypto.BTC/USD", "1", kStart, kStart + 86399, root.string()};
+    manager.setEndpoints({server.url(), server.url()});
+    const auto bars = manager.loadData();
+
+    // Binance was requested while the slow Pyth response was still pending.
+    ASSERT_EQ(served.size(), 2u);
+    const auto& pyth = served["/v1/shims/tradingview/history"];
+    const auto& binance = served["/fapi/v1/klines"];
+    EXPECT_LT(binance.first, pyth.second);
+    EXPECT_LT(pyth.first, binance.second);
+
+    // Pyth-only, two merged bars (Pyth prices, Binance volume), Binance-only.
+    ASSERT_EQ(bars.size(), 4u);
+    EXPECT_EQ(bars[0].timestamp, kStart * 1000L);
+    EXPECT_DOUBLE_EQ(bars[0].volume, 0.0);
+    EXPECT_DOUBLE_EQ(bars[1].close, static_cast<double>((kStart + 60) % 1000));
+    EXPECT_DOUBLE_EQ(bars[1].volume, 5.0);
+    EXPECT_EQ(bars[2].num_trades, 9);
+    EXPECT_EQ(bars[3].timestamp, (kStart + 180) * 1000L);
+    EXPECT_DOUBLE_EQ(bars[3].close, 1.5);
+
+    fs::remove_all(root);
+}
+
+TEST(RateLimiter, PacesSustainedLoadAtTheConfiguredRate) {
+    using Clock = std::chrono::steady_clock;
+    RateLimiter limiter{5, std::chrono::milliseconds{100}};
+
+    // The first five go through at once; the other ten refill at 50 per second.
+    const auto start = Clock::now();
+    for (int i = 0; i < 15; ++i) limiter.acquire();
+    const auto elapsed = Clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds{180});
+    EXPECT_LT(elapsed, std::chrono::milliseconds{1000});
+
+    EXPECT_THROW(RateLimiter(0, std::chrono::seconds{1}), std::invalid_argument);
+}
+
+TEST(RateLimiter, FollowsServerReportedUsageAndPauses) {
+    using Clock = std::chrono::steady_clock;
+    RateLimiter limiter{100, std::chrono::hours{1}};
+    limiter.observeUsed(90);
+    EXPECT_NEAR(limiter.available(), 10.0, 0.01);
+
+    limiter.pauseFor(std::chrono::milliseconds{50});
+    EXPECT_DOUBLE_EQ(limiter.available(), 0.0);
+
+    RateLimiter fast{10, std::chrono::milliseconds{100}};
+    fast.pauseFor(std::chrono::milliseconds{50});
+    const auto start = Clock::now();
+    fast.acquire();
+    EXPECT_GE(Clock::now() - start, std::chrono::milliseconds{50});
+}
+
+TEST(HttpClient, RetriesRateLimitResponsesAndAppliesUsedWeight) {
+    using Clock = std::chrono::steady_clock;
+    std::atomic<int> requests{0};
+    StubHttpServer server{[&](const StubHttpServer::Request& request) {
+        StubHttpServer::Response response;
+        EXPECT_EQ(request.query.at("symbol"), "BTCUSDT");
+        switch (requests++) {
+            case 0:
+                response.status = 429;
+                response.headers["Retry-After"] = "0";
+                break;
+            case 1:
+                response.status = 418; // IP ban
+                response.headers["Retry-After"] = "1";
+                break;
+            default:
+                response.body = "[]";
+                response.headers["X-MBX-USED-WEIGHT-1M"] = "2000";
+        }
+        return response;
+    }};
+
+    HttpClient::Config config;
+    config.capacity = 2400;
+    config.usedWeightHeader = "X-MBX-USED-WEIGHT-1M";
+    config.initialBackoff = std::chrono::milliseconds{10};
+    HttpClient client{server.url(), config};
+
+    const auto start = Clock::now();
+    const cpr::Response r = client.get("/fapi/v1/klines", cpr::Parameters{{"symbol", "BTCUSDT"}}, 10);
+    EXPECT_EQ(r.status_code, 200);
+    EXPECT_EQ(requests.load(), 3);
+    // The 418's Retry-After paused the limiter, not a fixed sleep.
+    EXPECT_GE(Clock::now() - start, std::chrono::milliseconds{1000});
+    // The server's count (2000 of 2400 used) overrides the local estimate.
+    EXPECT_LE(client.limiter().available(), 401.0);
+}
+
+TEST(HttpClient, FailsFastOnClientErrorsAndGivesUpAfterMaxAttempts) {
+    std::atomic<int> requests{0};
+    StubHttpServer server{[&](const StubHttpServer::Request& request) {
+        ++requests;
+        StubHttpServer::Response response;
+        response.status = request.path == "/bad" ? 400 : 503;
+        response.body = "{\"msg\":\"nope\"}";
+        return response;
+    }};
+
+    HttpClient::Config config;
+    config.maxAttempts = 3;
+    config.initialBackoff = std::chrono::milliseconds{1};
+    HttpClient client{server.url(), config};
+
+    try {
+        client.get("/bad", {});
+        FAIL() << "expected a 400 to throw";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("HTTP 400"), std::string::npos);
+    }
+    EXPECT_EQ(requests.load(), 1);
+
+    EXPECT_THROW(client.get("/busy", {}), std::runtime_error);
+    EXPECT_EQ(requests.load(), 4);
+}
+
+TEST(BinancePriceSource, RecoversFromRateLimitThroughSharedClient) {
+    constexpr long kStart = 1672531200;
+    std::atomic<int> requests{0};
+    StubHttpServer server{[&](const StubHttpServer::Request&) {
+        StubHttpServer::Response response;
+        if (requests++ == 0) {
+            response.status = 429;
+            response.headers["Retry-After"] = "0";
+        } else {
+            response.body = binanceBody({kStart, kStart + 60});
+            response.headers["X-MBX-USED-WEIGHT-1M"] = "20";
+        }
+        return response;
+    }};
+
+    BinancePriceSource source{"Crypto.BTC/USD", "1", kStart, kStart + 120, server.url()};
+    const auto bars = source.fetch();
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_EQ(bars[1].timestamp, (kStart + 60) * 1000L);
+    EXPECT_EQ(requests.load(), 2);
+
+    // Sources on the same host share one client, hence one rate limit.
+    const auto client = HttpClient::shared(server.url(), BinancePriceSource::httpConfig());
+    EXPECT_EQ(client.get(), HttpClient::shared(server.url(), BinancePriceSource::httpConfig()).get());
+    EXPECT_LE(client->limiter().available(), 2380.5);
+}
+
+TEST(HttpClient, SharesClientsPerHostAndConfig) {
+    const std::string host = "http://127.0.0.1:9"; // never contacted
+    const auto binance = HttpClient::shared(host, BinancePriceSource::httpConfig());
+    const auto pyth = HttpClient::shared(host, PythPriceSource::httpConfig());
+
+    // One host serving both APIs still gets each API's own limits.
+    EXPECT_NE(binance.get(), pyth.get());
+    EXPECT_DOUBLE_EQ(binance->limiter().capacity(), 2400.0);
+    EXPECT_DOUBLE_EQ(pyth->limiter().capacity(), 30.0);
+    EXPECT_EQ(pyth.get(), HttpClient::shared(host, PythPriceSource::httpConfig()).get());
+}
+
+TEST(HttpClient, ReusesKeepAliveConnections) {
+    std::atomic<int> requests{0};
+    StubHttpServer server{[&](const StubHttpServer::Request&) {
+        ++requests;
+        StubHttpServer::Response response;
+        response.body = "[]";
+        return response;
+    }, true};
+
+    HttpClient client{server.url(), HttpClient::Config{}};
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(client.get("/fapi/v1/klines", cpr::Parameters{{"i", std::to_string(i)}}).status_code, 200);
+    }
+    EXPECT_EQ(requests.load(), 5);
+    EXPECT_EQ(server.connections(), 1u); // every request went over the first connection
+}
@@ -0,0 +1,661 @@
+#include <gtest/gtest.h>
+#include "core/ResultsWriter.h"
+#include "engine/BacktestManager.h"
+#include "engine/ParameterGrid.h"
+#include "engine/PortfolioEngine.h"
+#include "sma_cross/SmaCrossStrategy.h"
+#include "strategy/StrategyFactory.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+// Counts every global heap allocation in this test binary.
+namespace {
+std::atomic<std::size_t> gAllocations{0};
+}
+
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Rising prices, one bar per minute.
+std::vector<Bar> risingBars(std::size_t n) {
+    std::vector<Bar> bars;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double price = 100.0 + static_cast<double>(i);
+        bars.push_back({1672531200000 + static_cast<std::int64_t>(i) * 60000, price, price, price, price, 1.0});
+    }
+    return bars;
+}
+
+// Goes long on the first bar with perTradeSize and closes after params.holdBars bars.
+class HoldForStrategy : public IStrategy {
+public:
+    explicit HoldForStrategy(const StrategyConfig& config)
+        : config_{config}, holdBars_{static_cast<int>(config.param("holdBars", 1))} {}
+
+    void on_start(const Bar&, double) override {}
+
+    StrategyAction on_bar(const Bar&, const std::vector<Position>& openPositions, double) override {
+        StrategyAction action;
+        if (openPositions.empty() && !done_) {
+            action.openRequests.push_back({.side = Side::Long, .sizeUsd = config_.perTradeSize});
+        } else if (!openPositions.empty() && ++held_ >= holdBars_) {
+            action.closeCurrentPosition = true;
+            done_ = true;
+        }
+        return action;
+    }
+
+    void on_finish() override {}
+
+    const StrategyConfig& getConfig() const override { return config_; }
+
+private:
+    StrategyConfig config_;
+    int holdBars_;
+    int held_{0};
+    bool done_{false};
+};
+
+class VectorPriceSource : public PriceSource {
+public:
+    explicit VectorPriceSource(std::vector<Bar> bars) : bars_{std::move(bars)} {}
+    std::vector<Bar> fetch() override { return bars_; }
+
+private:
+    std::vector<Bar> bars_;
+};
+
+} // namespace
+
+TEST(ExecutionEngine, StreamingRunMatchesVectorRun) {
+    StrategyConfig config;
+    config.perTradeSize = 1000.0;
+    config.params["holdBars"] = 7;
+    const auto bars = risingBars(40);
+
+    ExecutionEngine fromVector{std::make_shared<HoldForStrategy>(config), false};
+    fromVector.run(bars);
+
+    VectorPriceSource source{bars};
+    ExecutionEngine fromSource{std::make_shared<HoldForStrategy>(config), false};
+    fromSource.run(source, 3);
+
+    EXPECT_EQ(fromSource.account().summarize().totalTrades, 1);
+    EXPECT_DOUBLE_EQ(fromSource.account().getBalance(), fromVector.account().getBalance());
+}
+
+TEST(ExecutionEngine, SeriesRunMatchesVectorRun) {
+    StrategyConfig config;
+    config.perTradeSize = 1000.0;
+    config.params["holdBars"] = 5;
+    const auto bars = risingBars(20);
+
+    ExecutionEngine fromVector{std::make_shared<HoldForStrategy>(config), false};
+    fromVector.run(bars);
+
+    ExecutionEngine fromSeries{std::make_shared<HoldForStrategy>(config), false};
+    fromSeries.run(BarSeries::fromBars(bars));
+
+    EXPECT_EQ(fromSeries.account().summarize().totalTrades, 1);
+    EXPECT_DOUBLE_EQ(fromSeries.account().getBalance(), fromVector.account().getBalance());
+}
+
+TEST(ExecutionEngine, BatchSignalsMatchBarByBarRun) {
+    // Oscillating prices, long enough to span several signal windows.
+    std::vector<Bar> bars;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        const double x = static_cast<double>(i);
+        const double price = 100.0 + 8.0 * std::sin(x * 0.013) + 1.5 * std::sin(x * 0.31);
+        bars.push_back({1672531200000 + static_cast<std::int64_t>(i) * 60000, price, price + 0.1, price - 0.1,
+                        price, 1.0});
+    }
+    // With more than one slot SmaCross falls back to on_bar for a full
+    // series too, so both runs must still agree (no batch-only pyramiding).
+    for (const std::size_t slots : {1u, 3u}) {
+        SCOPED_TRACE(slots);
+        StrategyConfig config;
+        config.initialCapital = 25000.0;
+        config.perTradeSize = 10000.0;
+        config.maxOpenPositions = slots;
+
+        auto batchStrategy = std::make_shared<SmaCrossStrategy>(config);
+        EXPECT_EQ(batchStrategy->supportsBatch(), slots == 1);
+        ExecutionEngine batched{batchStrategy, false};
+        batched.run(bars);
+
+        // Streaming always goes through on_bar.
+        VectorPriceSource source{bars};
+        ExecutionEngine barByBar{std::make_shared<SmaCrossStrategy>(config), false};
+        barByBar.run(source);
+
+        const auto expected = barByBar.account().summarize();
+        const auto actual = batched.account().summarize();
+        EXPECT_GT(expected.totalTrades, 10);
+        EXPECT_EQ(actual.totalTrades, expected.totalTrades);
+        EXPECT_EQ(actual.longTrades, expected.longTrades);
+        EXPECT_NEAR(actual.netPnl, expected.netPnl, 1e-6);
+    }
+}
+
+namespace {
+
+// Trades continuously (entries with SL/TP, timed exits) and records whether
+// any heap allocation happened since its previous on_bar call, i.e. during
+// one full iteration of the engine's bar loop.
+class AllocationProbeStrategy : public IStrategy {
+public:
+    void on_start(const Bar&, double) override {}
+
+    StrategyAction on_bar(const Bar& bar, const std::vector<Position>& openPositions, double) override {
+        const std::size_t now = gAllocations.load(std::memory_order_relaxed);
+        if (++bars_ > kWarmupBars && now != lastAllocations_) {
+            ++barsThatAllocated_;
+        }
+
+        StrategyAction action;
+        if (openPositions.empty()) {
+            action.openRequests.push_back({.side = (bars_ % 2) ? Side::Long : Side::Short,
+                                           .sizeUsd = 1000.0,
+                                           .stopLossPrice = bar.close * ((bars_ % 2) ? 0.99 : 1.01),
+                                           .takeProfitPrice = bar.close * ((bars_ % 2) ? 1.01 : 0.99)});
+            held_ = 0;
+        } else if (++held_ >= 3) {
+            action.closeCurrentPosition = true;
+        }
+
+        lastAllocations_ = gAllocations.load(std::memory_order_relaxed);
+        return action;
+    }
+
+    void on_finish() override {}
+
+    const StrategyConfig& getConfig() const override { return config_; }
+
+    static constexpr std::size_t kWarmupBars = 2;
+    std::size_t barsThatAllocated_{0};
+
+private:
+    StrategyConfig config_;
+    std::size_t bars_{0};
+    std::size_t lastAllocations_{0};
+    int held_{0};
+};
+
+} // namespace
+
+TEST(ExecutionEngine, BarLoopDoesNotAllocate) {
+    std::vector<Bar> bars;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        const double price = 100.0 + 3.0 * std::sin(static_cast<double>(i) * 0.2);
+        bars.push_back({1672531200000 + static_cast<std::int64_t>(i) * 60000, price, price + 1.5, price - 1.5,
+                        price, 1.0});
+    }
+
+    auto strategy = std::make_shared<AllocationProbeStrategy>();
+    ExecutionEngine engine{strategy, false};
+    engine.reserveTrades(bars.size());
+    engine.run(bars);
+
+    EXPECT_GT(engine.account().summarize().totalTrades, 1000);
+    EXPECT_EQ(strategy->barsThatAllocated_, 0u);
+}
+
+TEST(StrategyAction, OrderListIsBoundedAndInline) {
+    StrategyAction action;
+    for (std::size_t i = 0; i < OrderList::kCapacity; ++i) {
+        action.openRequests.push_back({.sizeUsd = static_cast<double>(i)});
+    }
+    EXPECT_EQ(action.openRequests.size(), OrderList::kCapacity);
+    EXPECT_DOUBLE_EQ(action.openRequests[2].sizeUsd, 2.0);
+    EXPECT_THROW(action.openRequests.push_back({}), std::length_error);
+}
+
+namespace {
+
+// Records the (symbol, timestamp) of every bar it is given.
+class RecordingStrategy : public IStrategy {
+public:
+    RecordingStrategy(int symbol, std::vector<std::pair<int, std::int64_t>>& log) : symbol_{symbol}, log_{log} {}
+
+    void on_start(const Bar&, double) override {}
+    StrategyAction on_bar(const Bar& bar, const std::vector<Position>&, double) override {
+        log_.emplace_back(symbol_, bar.timestamp);
+        return {};
+    }
+    void on_finish() override {}
+    const StrategyConfig& getConfig() const override { return config_; }
+
+private:
+    StrategyConfig config_;
+    int symbol_;
+    std::vector<std::pair<int, std::int64_t>>& log_;
+};
+
+} // namespace
+
+TEST(PortfolioEngine, MergesSymbolsInTimestampOrder) {
+    std::vector<std::pair<int, std::int64_t>> log;
+    PortfolioEngine portfolio{10000.0, false};
+    const std::vector<std::vector<std::int64_t>> timestamps = {{1, 4, 5, 9}, {2, 4, 6}, {}, {0, 3, 10, 11}};
+    for (std::size_t s = 0; s < timestamps.size(); ++s) {
+        BarSeries bars;
+        for (auto ts : timestamps[s]) {
+            bars.push_back({ts, 100, 100, 100, 100, 1.0});
+        }
+        portfolio.addSymbol("S" + std::to_string(s), std::make_shared<RecordingStrategy>(static_cast<int>(s), log),
+                            std::move(bars));
+    }
+    portfolio.run();
+
+    const std::vector<std::pair<int, std::int64_t>> expected = {
+        {3, 0}, {0, 1}, {1, 2}, {3, 3}, {0, 4}, {1, 4}, {0, 5}, {1, 6}, {0, 9}, {3, 10}, {3, 11}};
+    EXPECT_EQ(log, expected);
+    // The shared account is marked once per distinct timestamp.
+    EXPECT_EQ(portfolio.account().equityCurve().bars(), 10u);
+
+    BarSeries unsorted;
+    unsorted.push_back({2, 1, 1, 1, 1, 1});
+    unsorted.push_back({1, 1, 1, 1, 1, 1});
+    EXPECT_THROW(portfolio.addSymbol("bad", std::make_shared<RecordingStrategy>(9, log), unsorted),
+                 std::invalid_argument);
+}
+
+TEST(PortfolioEngine, SymbolsShareAccountMargin) {
+    StrategyConfig config;
+    config.perTradeSize = 1000.0;
+    config.params["holdBars"] = 1000; // never closes within the run
+
+    // Capital covers one position, so whichever symbol signals first takes the
+    // margin and the other symbol's entry is rejected.
+    PortfolioEngine portfolio{1500.0, false};
+    portfolio.addSymbol("A", std::make_shared<HoldForStrategy>(config), BarSeries::fromBars(risingBars(10)));
+    portfolio.addSymbol("B", std::make_shared<HoldForStrategy>(config), BarSeries::fromBars(risingBars(10)));
+    portfolio.run();
+
+    EXPECT_EQ(portfolio.engine(0).positions().size(), 1u);
+    EXPECT_TRUE(portfolio.engine(1).positions().empty());
+    EXPECT_DOUBLE_EQ(portfolio.engine(0).usedMargin(), 1000.0);
+    EXPECT_DOUBLE_EQ(portfolio.account().usedMargin(), 1000.0);
+    EXPECT_DOUBLE_EQ(portfolio.account().availableMargin(), 500.0);
+}
+
+namespace {
+
+// Replays one scripted action per bar and records the ids of the open
+// positions it was shown.
+class ScriptedStrategy : public IStrategy {
+public:
+    ScriptedStrategy(const StrategyConfig& config, std::vector<StrategyAction> script)
+        : config_{config}, script_{std::move(script)} {}
+
+    void on_start(const Bar&, double) override {}
+
+    StrategyAction on_bar(const Bar&, const std::vector<Position>& openPositions, double) override {
+        std::vector<std::uint64_t> ids;
+        for (const auto& pos : openPositions) {
+            ids.push_back(pos.id);
+        }
+        seen.push_back(ids);
+        return bar_ < script_.size() ? script_[bar_++] : StrategyAction{};
+    }
+
+    void on_finish() override {}
+    const StrategyConfig& getConfig() const override { return config_; }
+
+    std::vector<std::vector<std::uint64_t>> seen;
+
+private:
+    StrategyConfig config_;
+    std::vector<StrategyAction> script_;
+    std::size_t bar_{0};
+};
+
+Bar rangeBar(std::int64_t minute, double low, double high) {
+    return {1672531200000 + minute * 60000, 100.0, high, low, 100.0, 1.0};
+}
+
+} // namespace
+
+TEST(ExecutionEngine, ManagesManyPositionsThroughLevelBooks) {
+    StrategyConfig config;
+    config.initialCapital = 100000.0;
+    config.maxOpenPositions = 10;
+
+    std::vector<StrategyAction> script(6);
+    // Bar 0: four long legs (ids 1-4) with staggered stops and targets.
+    for (int k = 0; k < 4; ++k) {
+        script[0].openRequests.push_back({.side = Side::Long, .sizeUsd = 1000.0,
+                                          .stopLossPrice = 96.0 + k, .takeProfitPrice = 104.0 - k});
+    }
+    // Bar 1: a short (id 5) and an unprotected long (id 6).
+    script[1].openRequests.push_back({.side = Side::Short, .sizeUsd = 1000.0,
+                                      .stopLossPrice = 105.0, .takeProfitPrice = 90.0});
+    script[1].openRequests.push_back({.side = Side::Long, .sizeUsd = 1000.0});
+    script[3].closePositionIds.push_back(2);
+    script[4].closeCurrentPosition = true;
+    script[5].closeAllPositions = true;
+
+    auto strategy = std::make_shared<ScriptedStrategy>(config, script);
+    ExecutionEngine engine{strategy, false};
+    engine.run(std::vector<Bar>{rangeBar(0, 100, 100), rangeBar(1, 100, 100),
+                                // Crosses the 98 and 99 stops and the 101/102 targets:
+                                // ids 3 and 4 are stopped out, stops winning over targets.
+                                rangeBar(2, 97.5, 102.5),
+                                rangeBar(3, 100, 100), rangeBar(4, 100, 100), rangeBar(5, 100, 100),
+                                rangeBar(6, 100, 100)});
+
+    using Ids = std::vector<std::uint64_t>;
+    ASSERT_EQ(strategy->seen.size(), 7u);
+    EXPECT_EQ(strategy->seen[1], (Ids{1, 2, 3, 4}));
+    EXPECT_EQ(strategy->seen[3], (Ids{1, 2, 5, 6}));
+    EXPECT_EQ(strategy->seen[4], (Ids{1, 5, 6}));
+    EXPECT_EQ(strategy->seen[5], (Ids{5, 6}));
+    EXPECT_TRUE(strategy->seen[6].empty());
+
+    const auto summary = engine.account().summarize();
+    EXPECT_EQ(summary.totalTrades, 6);
+    EXPECT_NEAR(summary.netPnl, -30.0, 1e-9); // -20 (stop at 98) and -10 (stop at 99)
+    EXPECT_DOUBLE_EQ(engine.account().usedMargin(), 0.0);
+}
+
+TEST(ExecutionEngine, CapsOpenPositions) {
+    StrategyConfig config;
+    config.maxOpenPositions = 2;
+    std::vector<StrategyAction> script(1);
+    for (int k = 0; k < 4; ++k) {
+        script[0].openRequests.push_back({.side = Side::Long, .sizeUsd = 100.0});
+    }
+    ExecutionEngine engine{std::make_shared<ScriptedStrategy>(config, script), false};
+    engine.run(std::vector<Bar>{rangeBar(0, 100, 100)});
+    EXPECT_EQ(engine.positions().size(), 2u);
+
+    config.maxOpenPositions = 0;
+    EXPECT_THROW(ExecutionEngine(std::make_shared<ScriptedStrategy>(config, script), false), std::invalid_argument);
+}
+
+namespace {
+
+Bar ohlcBar(std::int64_t minute, double open, double high, double low, double close) {
+    return {1672531200000 + minute * 60000, open, high, low, close, 1.0};
+}
+
+} // namespace
+
+TEST(ExecutionEngine, IntrabarPathDecidesStopVersusTarget) {
+    // A long with both its stop (95) and target (105) inside the next bar.
+    auto exitPrice = [](IntrabarPath path) {
+        StrategyConfig config;
+        config.intrabarPath = path;
+        std::vector<StrategyAction> script(1);
+        script[0].openRequests.push_back(
+            {.side = Side::Long, .sizeUsd = 1000.0, .stopLossPrice = 95.0, .takeProfitPrice = 105.0});
+        ExecutionEngine engine{std::make_shared<ScriptedStrategy>(config, script), false};
+        engine.run(std::vector<Bar>{ohlcBar(0, 100, 100, 100, 100), ohlcBar(1, 100, 106, 94, 100)});
+        return 100.0 + engine.account().summarize().netPnl / 10.0; // 10 units held
+    };
+    EXPECT_NEAR(exitPrice(IntrabarPath::StopFirst), 95.0, 1e-9);
+    EXPECT_NEAR(exitPrice(IntrabarPath::OpenHighLowClose), 105.0, 1e-9);
+    EXPECT_NEAR(exitPrice(IntrabarPath::OpenLowHighClose), 95.0, 1e-9);
+}
+
+TEST(ExecutionEngine, RestingOrdersFillOnThePricePath) {
+    StrategyConfig config;
+    config.maxOpenPositions = 10;
+    config.initialCapital = 100000.0;
+    config.intrabarPath = IntrabarPath::OpenHighLowClose;
+
+    std::vector<StrategyAction> script(4);
+    // Bar 0 (submitted at the close, live from bar 1):
+    script[0].openRequests.push_back({.side = Side::Long, .sizeUsd = 1000.0, .type = OrderType::Limit,
+                                      .limitPrice = 99.0, .id = 1});
+    script[0].openRequests.push_back({.side = Side::Long, .sizeUsd = 1000.0, .type = OrderType::StopLimit,
+                                      .limitPrice = 101.0, .stopPrice = 102.0, .id = 2});
+    script[0].openRequests.push_back({.side = Side::Short, .sizeUsd = 1000.0, .type = OrderType::Limit,
+                                      .limitPrice = 110.0, .expiryTimestamp = ohlcBar(1, 0, 0, 0, 0).timestamp,
+                                      .id = 3});
+    script[0].openRequests.push_back({.side = Side::Short, .sizeUsd = 1000.0, .type = OrderType::Stop,
+                                      .stopPrice = 90.0, .id = 4});
+    // Bar 2: move the short stop up, so the gap at bar 3's open triggers it.
+    script[2].replaceRequests.push_back({.side = Side::Short, .sizeUsd = 1000.0, .type = OrderType::Stop,
+                                         .stopPrice = 97.0, .id = 4});
+
+    auto strategy = std::make_shared<ScriptedStrategy>(config, script);
+    ExecutionEngine engine{strategy, false};
+    engine.run(std::vector<Bar>{
+        ohlcBar(0, 100, 100, 100, 100),
+        // Up to 103 triggers the stop-limit (not marketable at 102), down to 98
+        // fills the limit at 99 and then the stop-limit's limit leg at 101.
+        ohlcBar(1, 100, 103, 98, 100),
+        ohlcBar(2, 100, 100, 100, 100), // order 3 has expired by now
+        ohlcBar(3, 95, 96, 94, 95),     // gaps below the 97 stop: fills at the open
+    });
+
+    const auto& positions = engine.positions();
+    ASSERT_EQ(positions.size(), 3u);
+    EXPECT_DOUBLE_EQ(positions[0].entryPrice, 101.0); // stop-limit leg fills first on the way down
+    EXPECT_DOUBLE_EQ(positions[1].entryPrice, 99.0);
+    EXPECT_EQ(positions[2].side, Side::Short);
+    EXPECT_DOUBLE_EQ(positions[2].entryPrice, 95.0);
+    EXPECT_TRUE(engine.restingOrders().empty());
+}
+
+TEST(ExecutionEngine, MarketReplacementFillsAtTheCloseInsteadOfResting) {
+    StrategyConfig config;
+    config.maxOpenPositions = 2;
+    config.initialCapital = 100000.0;
+
+    std::vector<StrategyAction> script(2);
+    script[0].openRequests.push_back({.side = Side::Short, .sizeUsd = 1000.0, .type = OrderType::Limit,
+                                      .limitPrice = 110.0, .id = 7});
+    // Type left at its Market default: must not rest as a short limit at 0.
+    script[1].replaceRequests.push_back({.side = Side::Short, .sizeUsd = 1000.0, .id = 7});
+
+    ExecutionEngine engine{std::make_shared<ScriptedStrategy>(config, script), false};
+    engine.run(std::vector<Bar>{ohlcBar(0, 100, 100, 100, 100), ohlcBar(1, 100, 101, 99, 100),
+                                ohlcBar(2, 90, 95, 50, 60)});
+
+    EXPECT_TRUE(engine.restingOrders().empty());
+    ASSERT_EQ(engine.positions().size(), 1u);
+    EXPECT_EQ(engine.positions()[0].side, Side::Short);
+    EXPECT_DOUBLE_EQ(engine.positions()[0].entryPrice, 100.0); // bar 1's close
+}
+
+TEST(ExecutionEngine, CostModelChargesFeesSlippageAndFunding) {
+    StrategyConfig config;
+    config.costs.makerFeeRate = 0.0002;
+    config.costs.takerFeeRate = 0.0005;
+    config.costs.slippageBps = 10.0;
+    config.costs.volumeImpact = 0.001;
+    config.costs.fundingRate = 0.0001;
+    config.costs.fundingIntervalHours = 8.0;
+
+    // Enter long at bar 0's close, hold through two 8h funding intervals, and
+    // exit at bar 2's close. Every bar trades 100 units at 100.
+    std::vector<StrategyAction> script(3);
+    script[0].openRequests.push_back({.side = Side::Long, .sizeUsd = 1000.0});
+    script[2].closeCurrentPosition = true;
+    auto bar = [](std::int64_t interval) {
+        return Bar{1672531200000 + interval * 8 * 3'600'000, 100.0, 100.0, 100.0, 100.0, 100.0};
+    };
+
+    ExecutionEngine engine{std::make_shared<ScriptedStrategy>(config, script), false};
+    engine.run(std::vector<Bar>{bar(0), bar(1), bar(2)});
+
+    const double entry = 100.0 * (1.0 + 10e-4 + 0.001 * (10.0 / 100.0));
+    const double units = 1000.0 / entry;
+    const double exit = 100.0 * (1.0 - 10e-4 - 0.001 * (units / 100.0));
+    const double fees = entry * units * 0.0005 + exit * units * 0.0005;
+    const double funding = 2.0 * units * 100.0 * 0.0001;
+
+    const auto summary = engine.account().summarize();
+    EXPECT_NEAR(summary.totalFees, fees, 1e-9);
+    EXPECT_NEAR(summary.totalFunding, funding, 1e-9);
+    EXPECT_NEAR(summary.netPnl, (exit - entry) * units - fees - funding, 1e-9);
+}
+
+TEST(ExecutionEngine, MarksOpenPositionsToMarket) {
+    StrategyConfig config;
+    std::vector<StrategyAction> script(1);
+    script[0].openRequests.push_back({.side = Side::Long, .sizeUsd = 1000.0});
+
+    // 10 units bought at 100 and never closed: equity 10000, 10100, 9900.
+    ExecutionEngine engine{std::make_shared<ScriptedStrategy>(config, script), false};
+    engine.run(std::vector<Bar>{ohlcBar(0, 100, 100, 100, 100), ohlcBar(1, 100, 110, 100, 110),
+                                ohlcBar(2, 110, 110, 90, 90)});
+
+    const auto summary = engine.account().summarize();
+    EXPECT_EQ(summary.totalTrades, 0);
+    EXPECT_EQ(summary.risk.bars, 3u);
+    EXPECT_NEAR(summary.risk.finalEquity, 9900.0, 1e-9);
+    EXPECT_NEAR(summary.risk.maxDrawdown, 1.0 - 9900.0 / 10100.0, 1e-12);
+    EXPECT_DOUBLE_EQ(summary.risk.exposure, 1.0);
+    EXPECT_NEAR(engine.openPnl(), -100.0, 1e-9);
+}
+
+TEST(ResultsWriter, WritesRunAsColumnarJsonAndCsv) {
+    StrategyConfig config;
+    config.perTradeSize = 1000.0;
+    config.params["holdBars"] = 5;
+    ExecutionEngine engine{std::make_shared<HoldForStrategy>(config), false};
+    engine.recordEquityCurve(20);
+    engine.run(risingBars(20));
+
+    const std::string base = (std::filesystem::temp_directory_path() / "results_writer_run").string();
+    results::writeRun(base, engine.account(), {"hold_for", {{"holdBars", 5.0}}});
+
+    std::ifstream jsonFile(base + ".json");
+    const auto doc = nlohmann::json::parse(jsonFile);
+    EXPECT_EQ(doc["label"], "hold_for");
+    EXPECT_EQ(doc["parameters"]["holdBars"], 5.0);
+    EXPECT_EQ(doc["summary"]["totalTrades"], 1);
+    EXPECT_EQ(doc["trades"]["pnl"].size(), 1u);
+    EXPECT_DOUBLE_EQ(doc["trades"]["pnl"][0].get<double>(), engine.account().trades()[0].pnl);
+    EXPECT_EQ(doc["equity"]["equity"].size(), 20u);
+    EXPECT_DOUBLE_EQ(doc["risk"]["finalEquity"].get<double>(), engine.account().getBalance());
+
+    auto lineCount = [](const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::size_t lines = 0;
+        while (std::getline(file, line)) ++lines;
+        return lines;
+    };
+    EXPECT_EQ(lineCount(base + ".trades.csv"), 2u); // header + one trade
+    EXPECT_EQ(lineCount(base + ".equity.csv"), 21u);
+
+    for (const char* suffix : {".json", ".trades.csv", ".equity.csv"}) {
+        std::filesystem::remove(base + suffix);
+    }
+}
+
+TEST(ParameterGrid, EnumeratesCartesianProduct) {
+    ParameterGrid grid;
+    grid.addAxis("stopLossPercent", {1.0, 2.0});
+    grid.addAxis("smaPeriod", {10, 20, 30});
+    ASSERT_EQ(grid.size(), 6u);
+
+    StrategyConfig base;
+    base.perTradeSize = 500.0;
+    const auto first = grid.configAt(0, base);
+    EXPECT_DOUBLE_EQ(first.stopLossPercent, 1.0);
+    EXPECT_DOUBLE_EQ(first.param("smaPeriod", 0), 10);
+    EXPECT_DOUBLE_EQ(first.perTradeSize, 500.0);
+
+    const auto last = grid.configAt(5, base);
+    EXPECT_DOUBLE_EQ(last.stopLossPercent, 2.0);
+    EXPECT_DOUBLE_EQ(last.param("smaPeriod", 0), 30);
+}
+
+TEST(BacktestManager, SweepRunsEnginesOnPinnedWorkersOnly) {
+    auto bars = std::make_shared<const std::vector<Bar>>(risingBars(20));
+    ParameterGrid grid;
+    grid.addAxis("holdBars", {1, 2, 3, 4, 5, 6, 7, 8});
+
+    // Engines on the (unpinned) caller would read node 0's copy of the bars
+    // wherever the scheduler put them.
+    const auto caller = std::this_thread::get_id();
+    std::atomic<int> onCaller{0};
+    const auto results = BacktestManager::sweep(bars, grid, StrategyConfig{}, [&](const StrategyConfig& c) {
+        if (std::this_thread::get_id() == caller) onCaller.fetch_add(1);
+        return std::make_shared<HoldForStrategy>(c);
+    }, {.threads = 2, .pinThreads = true, .replicatePerNode = true});
+
+    EXPECT_EQ(results.size(), grid.size());
+    EXPECT_EQ(onCaller.load(), 0);
+}
+
+TEST(ParameterGrid, RejectsInvalidMaxOpenPositions) {
+    ParameterGrid grid;
+    EXPECT_THROW(grid.addAxis("maxOpenPositions", {2, -1}), std::invalid_argument);
+    EXPECT_THROW(grid.addAxis("maxOpenPositions", {1.5}), std::invalid_argument);
+    EXPECT_THROW(grid.addAxis("maxOpenPositions", {0}), std::invalid_argument);
+
+    StrategyConfig config;
+    EXPECT_THROW(ParameterGrid::apply(config, "maxOpenPositions", std::nan("")), std::invalid_argument);
+    ParameterGrid::apply(config, "maxOpenPositions", 3);
+    EXPECT_EQ(config.maxOpenPositions, 3u);
+}
+
+TEST(StrategyFactory, ConfigRejectsInvalidMaxOpenPositions) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "strategy_config_positions";
+    fs::create_directories(root / "strategies" / "probe");
+    const fs::path previous = fs::current_path();
+    fs::current_path(root);
+
+    StrategyFactory factory;
+    auto load = [&](const std::string& count) {
+        std::ofstream(root / "strategies" / "probe" / "config.json")
+            << R"({"initialCapital": 1000, "stopLossPercent": 1, "takeProfitPercent": 2,)"
+            << R"( "perTradeSize": 1, "maxOpenPositions": )" << count << "}";
+        return factory.loadConfig("probe");
+    };
+    // Same values the grid rejects, plus non-numbers.
+    for (const std::string bad : {"-1", "1.5", "0", "1e12", "\"3\"", "true"}) {
+        SCOPED_TRACE(bad);
+        EXPECT_THROW(load(bad), std::invalid_argument);
+    }
+    EXPECT_EQ(load("3").maxOpenPositions, 3u);
+    EXPECT_EQ(load("2.0").maxOpenPositions, 2u);
+
+    fs::current_path(previous);
+    fs::remove_all(root);
+}
+
+TEST(BacktestManager, SweepRanksResultsByNetPnl) {
+    auto bars = std::make_shared<const std::vector<Bar>>(risingBars(50));
+
+    ParameterGrid grid;
+    grid.addAxis("holdBars", {1, 10, 5});
+    grid.addAxis("perTradeSize", {1000.0, 2000.0});
+
+    StrategyConfig base;
+    auto results = BacktestManager::sweep(bars, grid, base, [](const StrategyConfig& c) {
+        return std::make_shared<HoldForStrategy>(c);
+    }, {.threads = 4});
+
+    ASSERT_EQ(results.size(), grid.size());
+    for (std::size_t i = 1; i < results.size(); ++i) {
+        EXPECT_GE(results[i - 1].summary.netPnl, results[i].summary.netPnl);
+    }
+    // Longest hold with the largest size wins on a rising market.
+    EXPECT_DOUBLE_EQ(results.front().config.param("holdBars", 0), 10);
+    EXPECT_DOUBLE_EQ(results.front().config.perTradeSize, 2000.0);
+    EXPECT_EQ(results.front().summary.totalTrades, 1);
+}
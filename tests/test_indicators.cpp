@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include "indicators/BatchKernels.h"
+#include "indicators/Indicators.h"
+
+using namespace indicators;
+
+namespace {
+
+std::vector<double> samplePrices(std::size_t n) {
+    std::vector<double> prices;
+    double p = 100.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        p += std::sin(static_cast<double>(i) * 0.7) * 2.0 + ((i % 3 == 0) ? -0.5 : 0.4);
+        prices.push_back(p);
+    }
+    return prices;
+}
+
+// Naive reference: statistics of prices[i - period + 1 .. i].
+double windowMean(const std::vector<double>& v, std::size_t i, std::size_t period) {
+    return std::accumulate(v.begin() + static_cast<std::ptrdiff_t>(i + 1 - period),
+                           v.begin() + static_cast<std::ptrdiff_t>(i + 1), 0.0) / static_cast<double>(period);
+}
+
+} // namespace
+
+TEST(RingBuffer, OverwritesOldestWhenFull) {
+    RingBuffer<int> ring{3};
+    int evicted = -1;
+    EXPECT_FALSE(ring.push(1, &evicted));
+    ring.push(2);
+    ring.push(3);
+    EXPECT_TRUE(ring.push(4, &evicted));
+    EXPECT_EQ(evicted, 1);
+    EXPECT_EQ(ring.front(), 2);
+    EXPECT_EQ(ring.back(), 4);
+    ring.pop_back();
+    ring.pop_front();
+    ASSERT_EQ(ring.size(), 1u);
+    EXPECT_EQ(ring[0], 3);
+}
+
+TEST(Sma, MatchesNaiveWindowAverage) {
+    const auto prices = samplePrices(500);
+    Sma sma{20};
+    for (std::size_t i = 0; i < prices.size(); ++i) {
+        sma.update(prices[i]);
+        EXPECT_EQ(sma.ready(), i + 1 >= 20);
+        if (sma.ready()) {
+            EXPECT_NEAR(sma.value(), windowMean(prices, i, 20), 1e-9);
+        }
+    }
+}
+
+TEST(Ema, SeedsWithSmaThenSmooths) {
+    Ema ema{3};
+    ema.update(1.0);
+    ema.update(2.0);
+    EXPECT_FALSE(ema.ready());
+    EXPECT_DOUBLE_EQ(ema.update(3.0), 2.0);
+    EXPECT_TRUE(ema.ready());
+    EXPECT_DOUBLE_EQ(ema.update(6.0), 2.0 + 0.5 * (6.0 - 2.0));
+}
+
+TEST(RollingMinMax, MatchesNaiveWindowExtremes) {
+    const auto prices = samplePrices(300);
+    RollingMax rollingMax{7};
+    RollingMin rollingMin{7};
+    for (std::size_t i = 0; i < prices.size(); ++i) {
+        const double hi = rollingMax.update(prices[i]);
+        const double lo = rollingMin.update(prices[i]);
+        const auto first = prices.begin() + static_cast<std::ptrdiff_t>(i >= 6 ? i - 6 : 0);
+        const auto last = prices.begin() + static_cast<std::ptrdiff_t>(i + 1);
+        EXPECT_DOUBLE_EQ(hi, *std::max_element(first, last));
+        EXPECT_DOUBLE_EQ(lo, *std::min_element(first, last));
+    }
+}
+
+TEST(RollingStdDev, MatchesTwoPassComputation) {
+    const auto prices = samplePrices(400);
+    RollingStdDev rolling{30};
+    for (std::size_t i = 0; i < prices.size(); ++i) {
+        rolling.update(prices[i]);
+        if (!rolling.ready()) continue;
+        const double mean = windowMean(prices, i, 30);
+        double sq = 0.0;
+        for (std::size_t k = i + 1 - 30; k <= i; ++k) {
+            sq += (prices[k] - mean) * (prices[k] - mean);
+        }
+        EXPECT_NEAR(rolling.mean(), mean, 1e-9);
+        EXPECT_NEAR(rolling.stddev(), std::sqrt(sq / 30.0), 1e-7);
+        EXPECT_NEAR(rolling.sampleStdDev(), std::sqrt(sq / 29.0), 1e-7);
+    }
+}
+
+TEST(Atr, UsesTrueRangeAndWilderSmoothing) {
+    Atr atr{2};
+    atr.update(Bar{0, 10, 12, 9, 11, 0});   // TR = 3
+    atr.update(Bar{0, 11, 15, 10, 14, 0});  // TR = max(5, 4, 1) = 5
+    EXPECT_TRUE(atr.ready());
+    EXPECT_DOUBLE_EQ(atr.value(), 4.0);
+    atr.update(Bar{0, 14, 14, 6, 7, 0});    // TR = max(8, 0, 8) = 8
+    EXPECT_DOUBLE_EQ(atr.value(), (4.0 * 1 + 8.0) / 2);
+}
+
+TEST(Rsi, BoundsAndDirection) {
+    Rsi rising{5};
+    for (int i = 0; i < 10; ++i) rising.update(100.0 + i);
+    EXPECT_TRUE(rising.ready());
+    EXPECT_DOUBLE_EQ(rising.value(), 100.0);
+
+    Rsi mixed{2};
+    mixed.update(10.0);
+    mixed.update(12.0); // +2
+    mixed.update(11.0); // -1
+    EXPECT_NEAR(mixed.value(), 100.0 - 100.0 / (1.0 + 1.0 / 0.5), 1e-12);
+}
+
+TEST(BatchKernels, MatchIncrementalIndicators) {
+    // Long enough to cover several full tiles plus a partial tail.
+    const auto prices = samplePrices(3 * batch::kLanes * batch::kSegment + 123);
+    const std::size_t n = prices.size();
+    std::vector<double> sma(n), ema(n), stddev(n);
+    batch::sma(prices.data(), n, 20, sma.data());
+    batch::ema(prices.data(), n, 20, ema.data());
+    batch::rollingStdDev(prices.data(), n, 20, stddev.data());
+
+    Sma incSma{20};
+    Ema incEma{20};
+    RollingStdDev incStd{20};
+    for (std::size_t i = 0; i < n; ++i) {
+        incSma.update(prices[i]);
+        incEma.update(prices[i]);
+        incStd.update(prices[i]);
+        if (i < 19) {
+            EXPECT_TRUE(std::isnan(sma[i]));
+            EXPECT_TRUE(std::isnan(ema[i]));
+            EXPECT_TRUE(std::isnan(stddev[i]));
+            continue;
+        }
+        EXPECT_NEAR(sma[i], incSma.value(), 1e-9);
+        EXPECT_NEAR(ema[i], incEma.value(), 1e-9);
+        EXPECT_NEAR(stddev[i], incStd.stddev(), 1e-6);
+    }
+}
+
+TEST(BatchKernels, ReturnsAndColumns) {
+    std::vector<Bar> bars(4);
+    const double closes[] = {100.0, 110.0, 99.0, 99.0};
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        bars[i].close = closes[i];
+    }
+    const auto close = batch::column(bars, &Bar::close);
+    ASSERT_EQ(close.size(), 4u);
+
+    std::vector<double> ret(4), logRet(4);
+    batch::returns(close.data(), close.size(), ret.data());
+    batch::logReturns(close.data(), close.size(), logRet.data());
+    EXPECT_TRUE(std::isnan(ret[0]));
+    EXPECT_NEAR(ret[1], 0.1, 1e-12);
+    EXPECT_NEAR(ret[2], -0.1, 1e-12);
+    EXPECT_DOUBLE_EQ(ret[3], 0.0);
+    EXPECT_NEAR(logRet[1], std::log(1.1), 1e-12);
+    EXPECT_THROW(batch::sma(close.data(), close.size(), 0, ret.data()), std::invalid_argument);
+}
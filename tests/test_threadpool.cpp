@@ -1,8 +1,275 @@
 #include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "core/Topology.h"
+#include "engine/NumaReplicated.h"
+#include "engine/Task.h"
 #include "engine/ThreadPool.h"
- 
+#include "engine/WorkStealingDeque.h"
+
 TEST(ThreadPool, ExecutesTask) {
     ThreadPool pool{1};
     auto future = pool.enqueue([] { return 42; });
     EXPECT_EQ(future.get(), 42);
-} 
\ No newline at end of file
+}
+
+TEST(Task, StoresSmallCallablesInlineAndAcceptsMoveOnly) {
+    int calls = 0;
+    auto small = [&calls] { ++calls; };
+    std::array<char, Task::kInlineSize + 1> padding{};
+    auto large = [&calls, padding] { calls += 1 + padding[0]; };
+    EXPECT_TRUE(Task::fitsInline<decltype(small)>());
+    EXPECT_FALSE(Task::fitsInline<decltype(large)>());
+
+    auto owned = std::make_unique<int>(5);
+    Task moveOnly{[&calls, p = std::move(owned)] { calls += *p; }};
+    Task moved{std::move(moveOnly)};
+    EXPECT_FALSE(moveOnly);
+
+    Task a{small};
+    Task b{large};
+    a();
+    b();
+    moved();
+    EXPECT_EQ(calls, 7);
+}
+
+TEST(WorkStealingDeque, OwnerPopsNewestAndThievesStealOldest) {
+    WorkStealingDeque<int> deque{2}; // grows past its initial capacity
+    for (int i = 0; i < 5; ++i) deque.push(i);
+
+    int value = -1;
+    ASSERT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 0);
+    ASSERT_TRUE(deque.pop(value));
+    EXPECT_EQ(value, 4);
+    ASSERT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 1);
+    ASSERT_TRUE(deque.pop(value));
+    ASSERT_TRUE(deque.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(deque.pop(value));
+    EXPECT_FALSE(deque.steal(value));
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDeque, EveryItemIsTakenExactlyOnceUnderContention) {
+    constexpr int kItems = 100000;
+    WorkStealingDeque<int> deque;
+    std::vector<std::atomic<int>> seen(kItems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            int value = 0;
+            while (!done.load() || !deque.empty()) {
+                if (deque.steal(value)) seen[value].fetch_add(1);
+            }
+        });
+    }
+    int value = 0;
+    for (int i = 0; i < kItems; ++i) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(value)) seen[value].fetch_add(1);
+    }
+    while (deque.pop(value)) seen[value].fetch_add(1);
+    done.store(true);
+    for (auto& thief : thieves) thief.join();
+
+    for (int i = 0; i < kItems; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "item " << i;
+    }
+}
+
+TEST(ThreadPool, SubmitRunsEveryTaskBeforeDestruction) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool{4};
+        for (int i = 0; i < 10000; ++i) {
+            pool.submit([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    EXPECT_EQ(count.load(), 10000);
+}
+
+TEST(ThreadPool, NestedSubmitsFromWorkersRun) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool{4};
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&pool, &count] {
+                for (int j = 0; j < 100; ++j) {
+                    pool.submit([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+    }
+    EXPECT_EQ(count.load(), 10000);
+}
+
+TEST(ThreadPool, EnqueueFromManyThreads) {
+    ThreadPool pool{4};
+    std::vector<std::thread> producers;
+    std::atomic<long> total{0};
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&pool, &total, p] {
+            std::vector<std::future<int>> futures;
+            for (int i = 0; i < 1000; ++i) {
+                futures.push_back(pool.enqueue([](int a, int b) { return a + b; }, p, i));
+            }
+            for (auto& future : futures) total += future.get();
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    EXPECT_EQ(total.load(), 4 * (999 * 1000 / 2) + 1000 * (0 + 1 + 2 + 3));
+}
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool{4};
+    std::vector<std::atomic<int>> hits(10007);
+    pool.parallel_for(0, hits.size(), [&hits](std::size_t i) { hits[i].fetch_add(1); });
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), 1) << "index " << i;
+    }
+
+    int untouched = 0;
+    pool.parallel_for(5, 5, [&untouched](std::size_t) { ++untouched; });
+    EXPECT_EQ(untouched, 0);
+}
+
+TEST(ThreadPool, ParallelForRethrowsBodyException) {
+    ThreadPool pool{4};
+    EXPECT_THROW(pool.parallel_for(0, 1000, [](std::size_t i) {
+        if (i == 637) throw std::runtime_error("boom");
+    }, 1), std::runtime_error);
+
+    // The pool is still usable afterwards.
+    std::atomic<int> count{0};
+    pool.parallel_for(0, 100, [&count](std::size_t) { count.fetch_add(1); });
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPool, NestedParallelForDoesNotDeadlock) {
+    ThreadPool pool{2};
+    std::atomic<int> count{0};
+    pool.parallel_for(0, 8, [&pool, &count](std::size_t) {
+        pool.parallel_for(0, 100, [&count](std::size_t) { count.fetch_add(1); }, 1);
+    }, 1);
+    EXPECT_EQ(count.load(), 800);
+}
+
+TEST(ThreadPool, ParallelForRunsAtMostSizeBodiesAtOnce) {
+    // Records the peak number of bodies running together.
+    struct Peak {
+        std::atomic<int> active{0};
+        std::atomic<int> peak{0};
+        void body() {
+            const int now = active.fetch_add(1) + 1;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+            active.fetch_sub(1);
+        }
+    };
+
+    ThreadPool pool{2};
+    Peak outside;
+    const auto caller = std::this_thread::get_id();
+    std::atomic<int> onCaller{0};
+    pool.parallel_for(0, 32, [&](std::size_t) {
+        if (std::this_thread::get_id() == caller) onCaller.fetch_add(1);
+        outside.body();
+    }, 1);
+    EXPECT_LE(outside.peak.load(), 2);
+    EXPECT_EQ(onCaller.load(), 0); // only pool workers run bodies
+
+    // Called from a worker, the caller counts as one of the pool's threads.
+    Peak nested;
+    pool.enqueue([&pool, &nested] {
+        pool.parallel_for(0, 32, [&nested](std::size_t) { nested.body(); }, 1);
+    }).get();
+    EXPECT_LE(nested.peak.load(), 2);
+}
+
+TEST(Topology, ParsesSysfsCpuLists) {
+    EXPECT_EQ(topology::parseCpuList("0-3,8-9,5\n"), (std::vector<int>{0, 1, 2, 3, 5, 8, 9}));
+    EXPECT_TRUE(topology::parseCpuList("").empty());
+    EXPECT_THROW(topology::parseCpuList("3-1"), std::invalid_argument);
+    EXPECT_THROW(topology::parseCpuList("0,x"), std::invalid_argument);
+}
+
+TEST(Topology, ReadsNodesAndSpreadsWorkersAcrossThem) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "topology_test_sysfs";
+    fs::remove_all(root);
+    const std::pair<const char*, const char*> nodes[] = {{"node1", "4-7"}, {"node0", "0-3"}, {"node2", "8"}};
+    for (const auto& [name, cpus] : nodes) {
+        fs::create_directories(root / name);
+        std::ofstream{root / name / "cpulist"} << cpus << "\n";
+    }
+    fs::create_directories(root / "power"); // not a node
+
+    // CPU 3 is outside the affinity mask; node2 is left without CPUs.
+    const auto topo = topology::Topology::fromSysfs(root.string(), {0, 1, 2, 4, 5, 6, 7});
+    fs::remove_all(root);
+
+    ASSERT_EQ(topo.nodeCount(), 2u);
+    EXPECT_EQ(topo.nodes()[0].id, 0);
+    EXPECT_EQ(topo.nodes()[0].cpus, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(topo.nodes()[1].cpus, (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_EQ(topo.cpuCount(), 7u);
+
+    // Alternate nodes until node 0 runs out, then every CPU once, then wrap.
+    std::vector<int> cpus;
+    for (std::size_t i = 0; i < 8; ++i) {
+        cpus.push_back(topo.place(i).cpu);
+    }
+    EXPECT_EQ(cpus, (std::vector<int>{0, 4, 1, 5, 2, 6, 7, 0}));
+    EXPECT_EQ(topo.place(1).node, 1u);
+
+    // No NUMA information: one node with every allowed CPU.
+    const auto flat = topology::Topology::fromSysfs((root / "missing").string(), {2, 0, 1});
+    ASSERT_EQ(flat.nodeCount(), 1u);
+    EXPECT_EQ(flat.nodes()[0].cpus, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(NumaReplicated, CopiesPerNodeAndServesTheCallersNode) {
+    const std::vector<int> data(1000, 7);
+    const int cpu = topology::Topology::system().nodes()[0].cpus.front();
+    const topology::Topology twoNodes{{{0, {cpu}}, {1, {cpu}}}};
+
+    const NumaReplicated<std::vector<int>> shared{data, false, twoNodes};
+    EXPECT_EQ(shared.copies(), 1u);
+    EXPECT_EQ(&shared.local(), &data);
+
+    const NumaReplicated<std::vector<int>> replicated{data, true, twoNodes};
+    ASSERT_EQ(replicated.copies(), 2u);
+    EXPECT_NE(&replicated.forNode(0), &data);
+    EXPECT_NE(&replicated.forNode(0), &replicated.forNode(1));
+    EXPECT_EQ(replicated.forNode(1), data);
+
+    std::thread worker([&] {
+        topology::pinCurrentThread({cpu, 1});
+        EXPECT_EQ(&replicated.local(), &replicated.forNode(1));
+    });
+    worker.join();
+    EXPECT_EQ(&replicated.local(), &replicated.forNode(0)); // this thread was never pinned
+}
+
+TEST(ThreadPool, PinnedWorkersRecordTheirNode) {
+    const auto& topo = topology::Topology::system();
+    ThreadPool pool{PoolOptions{4, true}};
+    std::vector<std::size_t> nodes(64);
+    pool.parallel_for(0, nodes.size(), [&nodes](std::size_t i) { nodes[i] = topology::currentNode(); }, 1);
+    for (std::size_t node : nodes) {
+        EXPECT_LT(node, topo.nodeCount());
+    }
+}